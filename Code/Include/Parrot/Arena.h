@@ -25,7 +25,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-extern struct ARENA *ArenaGame, *ArenaChapter, *ArenaRoom;
+extern struct ARENA *ArenaGame, *ArenaChapter, *ArenaRoom, *ArenaTables;
 
 struct ARENA* ArenaOpen(ULONG size, ULONG requirements);
 
@@ -0,0 +1,38 @@
+/**
+    $Id: Camera.h 1.0 2026/10/19 10:40:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+EXPORT VOID CameraInitialise(struct CAMERA* camera, UWORD roomWidth, UWORD viewWidth, WORD x);
+
+EXPORT VOID CameraSnap(struct CAMERA* camera, WORD x);
+
+EXPORT VOID CameraSetTarget(struct CAMERA* camera, WORD x);
+
+EXPORT VOID CameraFollow(struct CAMERA* camera, struct ACTOR* actor);
+
+EXPORT BOOL CameraUpdate(struct CAMERA* camera);
+
+EXPORT BOOL CameraGetPrefetch(struct CAMERA* camera, WORD* firstColumn, WORD* lastColumn);
@@ -37,6 +37,8 @@ EXPORT VOID GfxHide();
 
 EXPORT BOOL GfxIsPal();
 
+EXPORT UWORD GfxGetArch();
+
 EXPORT VOID GfxSetScrollOffset(UWORD vp, WORD x, WORD y);
 
 EXPORT VOID GfxSubmit(UWORD id);
@@ -51,6 +53,12 @@ EXPORT VOID GfxRectFill(UWORD vp, WORD x0, WORD y0, WORD x1, WORD y1);
 
 EXPORT VOID GfxBlitBitmap(UWORD id, struct IMAGE* image, WORD dx, WORD dy, WORD sx, WORD sy, WORD sw, WORD sh);
 
+EXPORT VOID GfxBlitBitmapMasked(UWORD id, struct IMAGE* image, UBYTE* mask, WORD dx, WORD dy, WORD sx, WORD sy, WORD sw, WORD sh);
+
+EXPORT UWORD GfxGetWriteBuffer(UWORD id);
+
+EXPORT VOID GfxGetViewSize(UWORD id, UWORD* width, UWORD* height);
+
 EXPORT VOID GfxLoadColours32(UWORD vp, ULONG* table);
 
 EXPORT VOID GfxMove(UWORD vp, WORD x, WORD y);
@@ -0,0 +1,90 @@
+/**
+    $Id: Host.h 1.0 2026/10/19 14:20:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef PARROT_HOST_H
+#define PARROT_HOST_H
+
+/*
+    Amiga types and the few exec calls the tools use, for building on a host computer with
+    PARROT_HOST defined. Only the converter and the String and Io modules are built this way.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef uint8_t       UBYTE;
+typedef int8_t        BYTE;
+typedef uint16_t      UWORD;
+typedef int16_t       WORD;
+typedef uint16_t      USHORT;
+typedef uint32_t      ULONG;
+typedef int32_t       LONG;
+typedef int16_t       BOOL;
+typedef void*         APTR;
+typedef char*         STRPTR;
+typedef const char*   CONST_STRPTR;
+typedef UBYTE*        PLANEPTR;
+
+#define VOID          void
+#define CONST         const
+
+#ifndef TRUE
+#define TRUE          1
+#endif
+
+#ifndef FALSE
+#define FALSE         0
+#endif
+
+#define RETURN_OK     0
+#define RETURN_FAIL   20
+
+#define MEMF_ANY      0
+#define MEMF_CHIP     (1L << 1)
+#define MEMF_CLEAR    (1L << 16)
+
+static inline APTR AllocVec(ULONG size, ULONG requirements)
+{
+  return (requirements & MEMF_CLEAR) != 0 ? calloc(1, size) : malloc(size);
+}
+
+static inline VOID FreeVec(APTR mem)
+{
+  free(mem);
+}
+
+#define AllocMem(SIZE, REQUIREMENTS) AllocVec(SIZE, REQUIREMENTS)
+
+static inline VOID CopyMem(CONST VOID* src, APTR dst, ULONG size)
+{
+  memcpy(dst, src, size);
+}
+
+#endif
@@ -34,6 +34,8 @@ EXTERN WORD  InMouseX;
 EXTERN WORD  InMouseY;
 
 EXTERN BYTE  KeyState[];
+EXTERN ULONG InputOverflows;
+EXTERN ULONG InputFrame;
 
 EXPORT VOID InputInitialise();
 
@@ -41,6 +43,14 @@ EXPORT VOID InputExit();
 
 EXPORT BOOL PopEvent(struct INPUTEVENT* ie);
 
+struct Task;
+
+EXPORT VOID InputSetSignal(struct Task* task, ULONG signalMask);
+
+EXPORT VOID InputNextFrame();
+
+EXPORT BOOL InputIsReplayingFast();
+
 EXPORT BOOL IsMenuDown();
 
 #define KC_ESC     0x45
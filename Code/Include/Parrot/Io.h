@@ -0,0 +1,52 @@
+/**
+    $Id: Io.h 1.0 2026/10/19 14:20:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+EXPORT UBYTE* IoReadFile(CONST CHAR* path, ULONG* size);
+
+EXPORT VOID IoFreeFile(UBYTE* data);
+
+EXPORT BOOL IoFileExists(CONST CHAR* path);
+
+EXPORT BOOL IffOpenWriter(struct IFF_WRITER* iw, CONST CHAR* path, ULONG formType);
+
+EXPORT BOOL IffCloseWriter(struct IFF_WRITER* iw);
+
+EXPORT VOID IffPushChunk(struct IFF_WRITER* iw, ULONG id);
+
+EXPORT VOID IffPopChunk(struct IFF_WRITER* iw);
+
+EXPORT VOID IffWriteBytes(struct IFF_WRITER* iw, CONST VOID* data, ULONG length);
+
+EXPORT VOID IffWriteUBYTE(struct IFF_WRITER* iw, UBYTE value);
+
+EXPORT VOID IffWriteUWORD(struct IFF_WRITER* iw, UWORD value);
+
+EXPORT VOID IffWriteULONG(struct IFF_WRITER* iw, ULONG value);
+
+EXPORT VOID IffWriteUWORDs(struct IFF_WRITER* iw, CONST UWORD* data, ULONG count);
+
+EXPORT VOID IffWritePad(struct IFF_WRITER* iw, ULONG length);
@@ -0,0 +1,71 @@
+/**
+    $Id: Log.h 1.0 2026/10/19 13:10:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#define LOG_LEVEL_ERROR  0
+#define LOG_LEVEL_WARN   1
+#define LOG_LEVEL_INFO   2
+#define LOG_LEVEL_TRACE  3
+
+/*
+    Messages above PARROT_LOG_LEVEL are compiled out along with their arguments.
+*/
+
+#if !defined(PARROT_LOG_LEVEL)
+#define PARROT_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+EXPORT VOID LogInitialise();
+
+EXPORT VOID LogShutdown();
+
+EXPORT VOID LogF(UWORD level, CONST_STRPTR pFmt, ...);
+
+EXPORT ULONG LogGetDropped();
+
+#if PARROT_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LogF(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...)
+#endif
+
+#if PARROT_LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...)  LogF(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...)
+#endif
+
+#if PARROT_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...)  LogF(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...)
+#endif
+
+#if PARROT_LOG_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE(...) LogF(LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define LOG_TRACE(...)
+#endif
@@ -27,15 +27,21 @@
 #ifndef PARROT_H
 #define PARROT_H
 
+#if defined(__M68K__)
+#define IS_M68K
+#elif defined(PARROT_HOST)
+#define IS_HOST
+#else
+#error "Unsupported Arch"
+#endif
+
+#if defined(IS_M68K)
 #include <exec/types.h>
 #include <exec/nodes.h>
 
 #include <Parrot/Private/SDI_compiler.h>
-
-#if defined(__M68K__)
-#define IS_M68K
 #else
-#error "Unsupported Arch"
+#include <Parrot/Host.h>
 #endif
 
 #define MAX_SCREENS            2
@@ -45,6 +51,11 @@
 #define MAX_ENTITY_NAME_LENGTH 29
 #define MAX_VIEW_LAYOUTS       2
 #define MAX_INPUT_EVENT_SIZE   32
+#define MAX_FRAME_CATCHUP      4
+#define MAX_RENDER_SKIP        2
+#define MAX_LOG_ENTRIES        64
+#define MAX_LOG_LENGTH         124
+#define DEFAULT_ARENA_SIZE     131072
 
 /**
     Typename consistency
@@ -165,9 +176,20 @@ struct INPUTEVENT
   WORD              ie_CursY;
 };
 
+#define INPUT_RECORDING_ID       MAKE_NODE_ID('P','I','N','P')
+#define INPUT_RECORDING_VERSION  1
+
+struct INPUT_RECORD
+{
+  ULONG             ir_Frame;
+  struct INPUTEVENT ir_Event;
+};
+
 struct ASSET
 {
   ULONG             as_ClassType;
+  UWORD             as_Refs;
+  UWORD             as_Pad;
   UWORD             as_Arch;
   UWORD             as_Id;
 };
@@ -227,6 +249,10 @@ struct GAME_INFO
   UWORD                     gi_StartPalette;
   UWORD                     gi_StartCursorPalette;
   UWORD                     gi_StartRoom;
+  ULONG                     gi_RoomArena;       /* Most ArenaRoom used by any room, 0 if unknown */
+  ULONG                     gi_RoomChip;        /* Most chip memory used by any room's images */
+  ULONG                     gi_ChapterArena;    /* Most ArenaChapter used by any room */
+  ULONG                     gi_TableArena;      /* Object tables that go on from the start tables */
 };
 
 /*
@@ -238,6 +264,7 @@ struct OBJECT_TABLE_ITEM
   UWORD ot_Id;
   UWORD ot_Archive;
   UWORD ot_Flags;
+  UWORD ot_ChunkId;
   ULONG ot_Size;
   APTR  ot_Ptr;
 };
@@ -281,8 +308,20 @@ struct IMAGE
   UWORD             im_Width;
   UWORD             im_Palette;
   ULONG             im_PlaneSize;
+  UWORD             im_Options;   /* See IMO_* */
+  UWORD             im_Type;      /* See IMT_* */
+  UBYTE*            im_Mask;
 };
 
+#define IMT_BITMAP        0
+#define IMT_ZPLANE        1
+
+/*
+    Image has a 1-bit cookie-cut mask plane stored after the bitplanes.
+    The mask is generated by the converter, it is never computed at runtime.
+*/
+#define IMO_MASK          (1 << 0)
+
 /*
 
   Verbs
@@ -298,6 +337,105 @@ struct VERBS
   UWORD  vb_Selected;
 };
 
+/*
+
+      Actor
+
+*/
+
+/*
+    Only the position for now, which the camera can follow. Actors are not drawn until the
+    converter exports costumes.
+*/
+struct ACTOR
+{
+  UWORD               ac_Id;
+  WORD                ac_X;
+  WORD                ac_Y;
+};
+
+/*
+
+      Layer
+
+*/
+
+struct LAYER
+{
+  struct IMAGE*       ly_Image;
+  UWORD               ly_Factor;      /* Scroll factor, 8.8 fixed. 256 scrolls with the room */
+  WORD                ly_Offset;      /* Position of the layer within the room bitmap */
+  UWORD               ly_Dirty;       /* Display buffers still needing this layer */
+};
+
+/*
+
+      Clock
+
+*/
+
+struct CLOCK_STATS
+{
+  ULONG               cs_Frames;        /* Frames drawn */
+  ULONG               cs_Ticks;         /* Logic ticks run */
+  ULONG               cs_Skipped;       /* Frames not drawn so logic could keep up */
+  ULONG               cs_FrameTime;     /* Work time of the last frame in microseconds */
+  ULONG               cs_FrameTimeAvg;  /* Running average over the last 16 frames or so */
+  ULONG               cs_FrameTimeMax;
+};
+
+/*
+
+      Log
+
+*/
+
+struct LOG_ENTRY
+{
+  UWORD               le_Level;
+  UWORD               le_Length;      /* Length of le_Text without the terminator */
+  CHAR                le_Text[MAX_LOG_LENGTH];
+};
+
+/*
+
+      Io
+
+*/
+
+#define MAX_IFF_DEPTH 4
+
+struct IFF_WRITER
+{
+  UBYTE*              iw_Data;
+  ULONG               iw_Size;
+  ULONG               iw_Capacity;
+  ULONG               iw_Chunks[MAX_IFF_DEPTH];   /* Offsets of the size of each open chunk */
+  UWORD               iw_Depth;
+  BOOL                iw_Failed;
+  CHAR                iw_Path[256];
+};
+
+/*
+
+      Camera
+
+*/
+
+#define CAMERA_EASE_SHIFT       3     /* Moves 1/8th of the remaining distance per frame */
+#define CAMERA_MAX_SPEED        8     /* Pixels per frame */
+#define CAMERA_PREFETCH_FRAMES  8
+
+struct CAMERA
+{
+  WORD                cm_X;           /* Left edge of the view in the room */
+  WORD                cm_Target;
+  WORD                cm_Speed;       /* Pixels moved last frame */
+  WORD                cm_Max;
+  UWORD               cm_ViewWidth;
+  struct ACTOR*       cm_Follow;
+};
+
 /*
 
       Room
@@ -341,6 +479,8 @@ struct ENTITY
   UWORD                en_Type;
   UWORD                en_Flags;
   struct RECT          en_HitBox;
+  UWORD                en_Image;      /* Patch shown whilst ETF_IS_OPEN, or 0 */
+  struct POINT         en_ImagePos;
   UBYTE                en_Name[MAX_ENTITY_NAME_LENGTH + 1];
 };
 
@@ -349,6 +489,8 @@ struct EXIT
   UWORD                ex_Type;
   UWORD                ex_Flags;
   struct RECT          ex_HitBox;
+  UWORD                ex_Image;
+  struct POINT         ex_ImagePos;
   UBYTE                ex_Name[MAX_ENTITY_NAME_LENGTH + 1];
   UWORD                ex_Target;
 };
@@ -358,10 +500,21 @@ struct ROOM
   UWORD               rm_Width;
   UWORD               rm_Height;
   UWORD               rm_Backdrops[MAX_ROOM_BACKDROPS];
+  UWORD               rm_Parallax[MAX_ROOM_BACKDROPS];   /* Scroll factor of each backdrop, 8.8 fixed */
+  UWORD               rm_ZPlane;
   UWORD               rm_Exits[MAX_ROOM_EXITS];
   UWORD               rm_Entities[MAX_ROOM_ENTITIES];
 };
 
+#define HIT_CELL_SHIFT       3
+#define HIT_CELL_SIZE        (1 << HIT_CELL_SHIFT)
+#define HIT_EXIT_BIT(N)      (1UL << (N))
+#define HIT_ENTITY_BIT(N)    (1UL << (MAX_ROOM_EXITS + (N)))
+
+#if (MAX_ROOM_EXITS + MAX_ROOM_ENTITIES) > 32
+#error "Hit grid cells can only hold 32 exits and entities"
+#endif
+
 #define UFLG_DEBUG    1
 #define UFLG_SCENE    2
 #define UFLG_SCROLL   4
@@ -372,15 +525,25 @@ struct UNPACKED_ROOM
 {
   struct ROOM*        ur_Room;
   struct IMAGE*       ur_Backdrops[MAX_ROOM_BACKDROPS];
+  struct IMAGE*       ur_ZPlane;
   struct EXIT*        ur_Exits[MAX_ROOM_EXITS];
   struct ENTITIES*    ur_Entities[MAX_ROOM_ENTITIES];
+  struct IMAGE*       ur_ExitImages[MAX_ROOM_EXITS];
+  struct IMAGE*       ur_EntityImages[MAX_ROOM_ENTITIES];
+  UBYTE               ur_ExitPatches[MAX_ROOM_EXITS];         /* Display buffers still needing the patch */
+  UBYTE               ur_EntityPatches[MAX_ROOM_ENTITIES];
+  ULONG*              ur_HitGrid;       /* See HIT_* */
+  UWORD               ur_HitCols;
+  UWORD               ur_HitRows;
   struct VERBS        ur_Verbs;
   UWORD               ur_Id;
   ULONG               ur_Unpacked;
   WORD                ur_CamX;
   WORD                ur_CamY;
+  struct CAMERA       ur_Camera;
   struct ENTITY*      ur_HoverEntity;
   UWORD               ur_UpdateFlags;
+  UWORD               ur_SceneBuffers;  /* Display buffers still needing the backdrop */
 };
 
 struct ENTRANCE
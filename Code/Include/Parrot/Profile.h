@@ -0,0 +1,65 @@
+/**
+    $Id: Profile.h 1.0 2026/10/19 12:40:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    Profiling is only built when PARROT_PROFILE is defined, otherwise the macros are empty
+    and cost nothing.
+*/
+
+#define PROFILE_INPUT      0
+#define PROFILE_HITTEST    1
+#define PROFILE_CAPTION    2
+#define PROFILE_BLIT       3
+#define PROFILE_SUBMIT     4
+#define PROFILE_LOAD       5
+#define MAX_PROFILE_ZONES  6
+
+#define PROFILE_BUCKETS    8
+
+#if defined(PARROT_PROFILE)
+
+EXPORT VOID ProfileBegin(UWORD zone);
+
+EXPORT VOID ProfileEnd(UWORD zone);
+
+EXPORT VOID ProfileFrame();
+
+EXPORT VOID ProfileDraw(UWORD vp, WORD y);
+
+#define PROFILE_BEGIN(ZONE)  ProfileBegin(ZONE)
+#define PROFILE_END(ZONE)    ProfileEnd(ZONE)
+#define PROFILE_FRAME()      ProfileFrame()
+#define PROFILE_DRAW(VP, Y)  ProfileDraw(VP, Y)
+
+#else
+
+#define PROFILE_BEGIN(ZONE)
+#define PROFILE_END(ZONE)
+#define PROFILE_FRAME()
+#define PROFILE_DRAW(VP, Y)
+
+#endif
@@ -29,5 +29,7 @@ VOID UnpackRoom(struct UNPACKED_ROOM* room, ULONG unpack);
 
 VOID PackRoom(struct UNPACKED_ROOM* room, ULONG unpack);
 
+VOID SetEntityOpen(struct UNPACKED_ROOM* room, struct ENTITY* entity, BOOL open);
+
 VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInfo);
 
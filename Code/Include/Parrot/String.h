@@ -25,12 +25,16 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <stdarg.h>
+
 ULONG StrLength(CONST_STRPTR pStr);
 
 ULONG StrLengthFormat(CHAR* pFmt, ...);
 
 ULONG StrFormat(CHAR* pBuffer, LONG pBufferCapacity, CHAR* pFmt, ...);
 
+ULONG StrFormatV(CHAR* pBuffer, LONG pBufferCapacity, CONST CHAR* pFmt, va_list pArgs);
+
 ULONG StrLen(CONST CHAR* pSrc);
 
 ULONG StrCopy(CHAR* pDst, ULONG pDstCapacity, CONST CHAR* pSrc);
@@ -41,6 +45,8 @@ BOOL StrEndsWith(CONST CHAR* test, CHAR value);
 
 VOID FillMem(UBYTE* pDst, ULONG length, UBYTE value);
 
+VOID XorMem(UBYTE* pDst, ULONG length, UBYTE value);
+
 #define InitStackVar(T, X) FillMem((UBYTE*) &X, sizeof(T), 0);
 
 CHAR* StrDuplicate(CONST CHAR* pSrc);
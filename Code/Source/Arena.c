@@ -41,6 +41,7 @@ struct ARENA
 struct ARENA* ArenaGame = NULL;
 struct ARENA* ArenaChapter = NULL;
 struct ARENA* ArenaRoom = NULL;
+struct ARENA* ArenaTables = NULL;
 
 EXPORT struct ARENA* ArenaOpen(ULONG size, ULONG requirements)
 {
@@ -96,6 +97,11 @@ CLEAN_EXIT:
 
 VOID ExitArenaNow()
 {
+  if (ArenaTables != NULL)
+  {
+    FreeVec(ArenaTables);
+  }
+
   if (ArenaRoom != NULL)
   {
     FreeVec(ArenaRoom);
@@ -161,7 +167,7 @@ EXPORT APTR NewObject(struct ARENA* arena, ULONG size, BOOL zeroFill)
 
   size = (size + 3) & ~0x03;
   
-  if ((arena->ah_Used + size) >= arena->ah_Size)
+  if ((arena->ah_Used + size) > arena->ah_Size)
   {
     PARROT_ERR
     (
@@ -181,7 +187,7 @@ EXPORT APTR NewObject(struct ARENA* arena, ULONG size, BOOL zeroFill)
     goto CLEAN_EXIT;
   }
 
-  result = (APTR) ((ULONG*) (arena + 1) + arena->ah_Used);
+  result = (APTR) ((UBYTE*) (arena + 1) + arena->ah_Used);
 
   if (zeroFill == TRUE)
   {
@@ -30,6 +30,8 @@
 #include <Parrot/Requester.h>
 #include <Parrot/String.h>
 #include <Parrot/Archive.h>
+#include <Parrot/Profile.h>
+#include <Parrot/Log.h>
 
 #include "Asset.h"
 
@@ -366,43 +368,78 @@ STATIC struct OBJECT_TABLE_ITEM* FindInTable(struct OBJECT_TABLE* table, UWORD i
     return NULL;
   }
 
-  if (id < table->ot_IdMin || id > table->ot_IdMax)
+  while (NULL != table)
   {
-    TraceF("Not in this table Min=%ld, Max=%ld, Need=%ld", (ULONG)table->ot_IdMin, (ULONG)table->ot_IdMax, (ULONG)item->ot_Id, (ULONG) id);
+    if (id >= table->ot_IdMin && id <= table->ot_IdMax)
+    {
+      item = &table->ot_Items[0];
 
-    return NULL;
+      while (item->ot_Id != 0)
+      {
+        if (item->ot_Id == id && (item->ot_Flags & arch) != 0)
+        {
+          return item;
+        }
+
+        item++;
+      }
+    }
+
+    table = (struct OBJECT_TABLE*) table->ot_Next;
   }
 
-  item = &table->ot_Items[0];
+  LOG_TRACE("Asset %ld not in table", (ULONG) id);
 
-  while (item->ot_Id != 0)
+  return NULL;
+}
+
+STATIC struct OBJECT_TABLE_ITEM* FindSharedInTable(struct OBJECT_TABLE* table, struct OBJECT_TABLE_ITEM* alias)
+{
+  struct OBJECT_TABLE_ITEM* item;
+  UWORD chunkId;
+
+  chunkId = alias->ot_ChunkId != 0 ? alias->ot_ChunkId : alias->ot_Id;
+
+  while (NULL != table)
   {
-    if (item->ot_Id == id && (item->ot_Flags & arch) != 0)
+    item = &table->ot_Items[0];
+
+    while (item->ot_Id != 0)
     {
-      return item;
+      if (item != alias && item->ot_Ptr != NULL && item->ot_Archive == alias->ot_Archive && item->ot_Flags == alias->ot_Flags &&
+          (item->ot_ChunkId != 0 ? item->ot_ChunkId : item->ot_Id) == chunkId)
+      {
+        return item;
+      }
+
+      item++;
     }
 
-    item++;
+    table = (struct OBJECT_TABLE*) table->ot_Next;
   }
 
   return NULL;
 }
 
 
-EXPORT APTR LoadAsset(struct ARENA* arena, UWORD archiveId, ULONG classType, UWORD assetId, UWORD arch)
+STATIC APTR LoadAssetInternal(struct ARENA* arena, UWORD archiveId, ULONG classType, UWORD assetId, UWORD arch)
 {
   struct ASSET* asset;
   struct ARCHIVE* archive;
   struct ASSET_FACTORY* factory;
   struct OBJECT_TABLE_ITEM* tableItem;
+  struct OBJECT_TABLE_ITEM* sharedItem;
   APTR   obj;
+  UWORD  chunkId;
   CHAR   strtype[5];
 
   asset = NULL;
   archive = NULL;
   factory = NULL;
   tableItem = NULL;
+  sharedItem = NULL;
   obj = NULL;
+  chunkId = assetId;
 
   factory = FindFactory(classType);
 
@@ -428,49 +465,72 @@ EXPORT APTR LoadAsset(struct ARENA* arena, UWORD archiveId, ULONG classType, UWO
       );
       return NULL;
     }
+  }
 
+  if (factory->af_Table != NULL)
+  {
     tableItem = FindInTable(factory->af_Table, assetId, arch);
+  }
+
+  if (tableItem == NULL && archiveId == ARCHIVE_UNKNOWN)
+  {
+    ErrorF("Could not find asset %s:%ld in its table", IDtoStr(classType, strtype), (ULONG) assetId);
+    return NULL;
+  }
 
-    if (tableItem != NULL && tableItem->ot_Ptr != NULL)
+  /*
+    The converter stores an image or palette once, and points the table rows of any copies
+    at it. The chunk may be in another archive under another id, and if it is already
+    loaded it is shared.
+  */
+  if (tableItem != NULL)
+  {
+    if (tableItem->ot_Ptr != NULL)
     {
-      obj = (struct ASSET*) tableItem->ot_Ptr;
-      return (APTR) (obj);
+      obj = tableItem->ot_Ptr;
+      (((struct ASSET*) obj) - 1)->as_Refs++;
+      return obj;
     }
 
-    archive = OpenArchive(tableItem->ot_Archive);
+    archiveId = tableItem->ot_Archive;
 
-    if (archive == NULL)
+    if (tableItem->ot_ChunkId != 0)
     {
-      ErrorF("Could not open archive %ld", (ULONG)archiveId);
-      return NULL;
+      chunkId = tableItem->ot_ChunkId;
     }
-  }
-  else
-  {
-    archive = OpenArchive(archiveId);
 
-    if (archive == NULL)
+    sharedItem = FindSharedInTable(factory->af_Table, tableItem);
+
+    if (sharedItem != NULL)
     {
-      ErrorF("Could not open archive %ld", (ULONG)archiveId);
-      return NULL;
+      obj = sharedItem->ot_Ptr;
+      (((struct ASSET*) obj) - 1)->as_Refs++;
+      tableItem->ot_Ptr = obj;
+      return obj;
     }
   }
 
-  asset = ReadAssetFromArchive(archive, classType, assetId, arch, factory->af_Size, factory->af_Ctor, arena);
+  archive = OpenArchive(archiveId);
 
-  if (asset == NULL)
+  if (archive == NULL)
   {
-    ErrorF("Could not load asset %s:%ld from archive %ld", IDtoStr(classType, strtype), (ULONG) assetId, (ULONG) archiveId);
+    ErrorF("Could not open archive %ld", (ULONG)archiveId);
     return NULL;
   }
 
-  obj = (APTR)(asset + 1);
+  asset = ReadAssetFromArchive(archive, classType, chunkId, arch, factory->af_Size, factory->af_Ctor, arena);
 
-  if (tableItem == NULL && factory->af_Table != NULL)
+  if (asset == NULL)
   {
-    tableItem = FindInTable(factory->af_Table, assetId, arch);
+    ErrorF("Could not load asset %s:%ld from archive %ld", IDtoStr(classType, strtype), (ULONG) assetId, (ULONG) archiveId);
+    return NULL;
   }
 
+  asset->as_Id = assetId;
+  asset->as_Refs = 1;
+
+  obj = (APTR)(asset + 1);
+
   if (tableItem != NULL)
   {
     tableItem->ot_Ptr = obj;
@@ -479,12 +539,26 @@ EXPORT APTR LoadAsset(struct ARENA* arena, UWORD archiveId, ULONG classType, UWO
   return obj;
 }
 
+EXPORT APTR LoadAsset(struct ARENA* arena, UWORD archiveId, ULONG classType, UWORD assetId, UWORD arch)
+{
+  APTR obj;
+
+  LOG_TRACE("Load asset %ld class %lx from archive %ld", (ULONG) assetId, classType, (ULONG) archiveId);
+
+  PROFILE_BEGIN(PROFILE_LOAD);
+  obj = LoadAssetInternal(arena, archiveId, classType, assetId, arch);
+  PROFILE_END(PROFILE_LOAD);
+
+  return obj;
+}
+
 EXPORT VOID UnloadAsset(struct ARENA* arena, APTR obj)
 {
   struct ASSET* asset;
   struct ARCHIVE* archive;
   struct ASSET_FACTORY* factory;
   struct OBJECT_TABLE_ITEM* tableItem;
+  struct OBJECT_TABLE* table;
   CHAR   strtype[5];
 
   archive = NULL;
@@ -521,13 +595,27 @@ EXPORT VOID UnloadAsset(struct ARENA* arena, APTR obj)
     goto CLEAN_EXIT;
   }
   
-  if (factory->af_Table != NULL)
+  if (asset->as_Refs > 1)
   {
-    tableItem = FindInTable(factory->af_Table, asset->as_Id, asset->as_Arch);
+    asset->as_Refs--;
+    return;
+  }
 
-    if (tableItem != NULL && tableItem->ot_Ptr == obj)
+  /*
+    A shared asset may be cached by more than one table row.
+  */
+  for (table = factory->af_Table; NULL != table; table = (struct OBJECT_TABLE*) table->ot_Next)
+  {
+    tableItem = &table->ot_Items[0];
+
+    while (tableItem->ot_Id != 0)
     {
-      tableItem->ot_Ptr = NULL;
+      if (tableItem->ot_Ptr == obj)
+      {
+        tableItem->ot_Ptr = NULL;
+      }
+
+      tableItem++;
     }
   }
 
@@ -545,47 +633,18 @@ CLEAN_EXIT:
   
 }
 
-EXPORT VOID LoadObjectTable(struct OBJECT_TABLE_REF* ref)
+STATIC BOOL ReadObjectTable(struct OBJECT_TABLE_REF* ref, struct OBJECT_TABLE* table)
 {
   struct ARCHIVE* archive;
-  struct OBJECT_TABLE* table;
-  struct ASSET_FACTORY* assetFactory;
   struct ContextNode* node;
   struct CHUNK_HEADER chunkHeader;
   LONG err;
   CHAR idtype[5];
   UWORD ii;
+  BOOL found;
 
-  table = NULL;
-  assetFactory = &AssetFactories[0];
-
-  while (assetFactory->af_NodeType != 0)
-  {
-    if (assetFactory->af_NodeType == ref->tr_ClassType)
-    {
-      table = assetFactory->af_Table;
-      break;
-    }
-
-    assetFactory++;
-  }
-
-  if (table == NULL)
-  {
-    PARROT_ERR(
-      "Unable to load Object Table from archive file.\n"
-      "Reason: Could not find suitable table to write to. (1)"
-      PARROT_ERR_STR("Class Type")
-      PARROT_ERR_INT("Chunk ID")
-      PARROT_ERR_INT("Archive ID"),
-      IDtoStr(ref->tr_ClassType, idtype),
-      (ULONG)ref->tr_ChunkHeaderId,
-      (ULONG)ref->tr_ArchiveId
-    );
+  found = FALSE;
 
-    return;
-  }
-  
   archive = OpenArchive(ref->tr_ArchiveId);
 
   if (archive == NULL)
@@ -600,7 +659,7 @@ EXPORT VOID LoadObjectTable(struct OBJECT_TABLE_REF* ref)
       (ULONG)ref->tr_ChunkHeaderId,
       (ULONG)ref->tr_ArchiveId
     );
-    return;
+    return FALSE;
   }
   
   if (archive->pa_File == NULL)
@@ -675,6 +734,7 @@ EXPORT VOID LoadObjectTable(struct OBJECT_TABLE_REF* ref)
           table->ot_Items[ii].ot_Ptr = NULL;
         }
 
+        found = TRUE;
         goto CLEAN_EXIT;
       }
 
@@ -710,6 +770,68 @@ EXPORT VOID LoadObjectTable(struct OBJECT_TABLE_REF* ref)
 CLEAN_EXIT:
 
   CloseIFF(archive->pa_Iff);
+
+  return found;
+}
+
+/*
+    Loads the table and every table that goes on from it through ot_NextRef. The start
+    table lives in its factory, the rest are held in ArenaTables.
+*/
+EXPORT VOID LoadObjectTable(struct OBJECT_TABLE_REF* ref)
+{
+  struct OBJECT_TABLE* table;
+  struct OBJECT_TABLE* next;
+  struct ASSET_FACTORY* assetFactory;
+  CHAR idtype[5];
+
+  table = NULL;
+  assetFactory = &AssetFactories[0];
+
+  while (assetFactory->af_NodeType != 0)
+  {
+    if (assetFactory->af_NodeType == ref->tr_ClassType)
+    {
+      table = assetFactory->af_Table;
+      break;
+    }
+
+    assetFactory++;
+  }
+
+  if (table == NULL)
+  {
+    PARROT_ERR(
+      "Unable to load Object Table from archive file.\n"
+      "Reason: Could not find suitable table to write to. (1)"
+      PARROT_ERR_STR("Class Type")
+      PARROT_ERR_INT("Chunk ID")
+      PARROT_ERR_INT("Archive ID"),
+      IDtoStr(ref->tr_ClassType, idtype),
+      (ULONG)ref->tr_ChunkHeaderId,
+      (ULONG)ref->tr_ArchiveId
+    );
+
+    return;
+  }
+
+  if (FALSE == ReadObjectTable(ref, table))
+  {
+    return;
+  }
+
+  while (0 != table->ot_NextRef.tr_ClassType)
+  {
+    next = NewObject(ArenaTables, sizeof(struct OBJECT_TABLE), FALSE);
+
+    if (NULL == next || FALSE == ReadObjectTable(&table->ot_NextRef, next))
+    {
+      return;
+    }
+
+    table->ot_Next = next;
+    table = next;
+  }
 }
 
 UWORD FindAssetArchive(UWORD assetId, ULONG classType, ULONG arch)
@@ -0,0 +1,189 @@
+/**
+    $Id: Camera.c, 1.0 2026/10/19 10:40:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Camera.h>
+
+/*
+    The camera eases its left edge towards a target each frame, moving by a fraction of
+    the remaining distance but never less than a pixel nor more than CAMERA_MAX_SPEED.
+
+    Only the scroll offset of the viewport changes as the camera moves, the room bitmap
+    is as wide as the room so no columns need redrawing.
+*/
+
+STATIC WORD ClampCamera(struct CAMERA* camera, WORD x)
+{
+  if (x > camera->cm_Max)
+  {
+    x = camera->cm_Max;
+  }
+
+  if (x < 0)
+  {
+    x = 0;
+  }
+
+  return x;
+}
+
+EXPORT VOID CameraInitialise(struct CAMERA* camera, UWORD roomWidth, UWORD viewWidth, WORD x)
+{
+  camera->cm_ViewWidth = viewWidth;
+  camera->cm_Max = 0;
+
+  if (roomWidth > viewWidth)
+  {
+    camera->cm_Max = roomWidth - viewWidth;
+  }
+
+  camera->cm_Follow = NULL;
+
+  CameraSnap(camera, x);
+}
+
+EXPORT VOID CameraSnap(struct CAMERA* camera, WORD x)
+{
+  x = ClampCamera(camera, x);
+
+  camera->cm_X = x;
+  camera->cm_Target = x;
+  camera->cm_Speed = 0;
+}
+
+EXPORT VOID CameraSetTarget(struct CAMERA* camera, WORD x)
+{
+  camera->cm_Follow = NULL;
+  camera->cm_Target = ClampCamera(camera, x);
+}
+
+/*
+  The camera only moves to keep a followed actor within the middle half of the view.
+*/
+EXPORT VOID CameraFollow(struct CAMERA* camera, struct ACTOR* actor)
+{
+  camera->cm_Follow = actor;
+}
+
+EXPORT BOOL CameraUpdate(struct CAMERA* camera)
+{
+  struct ACTOR* actor;
+  WORD delta, step, quarter;
+
+  actor = camera->cm_Follow;
+
+  if (actor != NULL)
+  {
+    quarter = camera->cm_ViewWidth >> 2;
+
+    if (actor->ac_X < camera->cm_Target + quarter)
+    {
+      camera->cm_Target = ClampCamera(camera, actor->ac_X - quarter);
+    }
+    else if (actor->ac_X > camera->cm_Target + camera->cm_ViewWidth - quarter)
+    {
+      camera->cm_Target = ClampCamera(camera, actor->ac_X - camera->cm_ViewWidth + quarter);
+    }
+  }
+
+  delta = camera->cm_Target - camera->cm_X;
+
+  if (delta == 0)
+  {
+    camera->cm_Speed = 0;
+    return FALSE;
+  }
+
+  step = delta >> CAMERA_EASE_SHIFT;
+
+  if (step == 0)
+  {
+    step = delta > 0 ? 1 : -1;
+  }
+  else if (step > CAMERA_MAX_SPEED)
+  {
+    step = CAMERA_MAX_SPEED;
+  }
+  else if (step < -CAMERA_MAX_SPEED)
+  {
+    step = -CAMERA_MAX_SPEED;
+  }
+
+  camera->cm_Speed = step;
+  camera->cm_X += step;
+
+  return TRUE;
+}
+
+/*
+  Gets the 8 pixel columns of the room that will scroll into view over the next
+  CAMERA_PREFETCH_FRAMES frames, based on the direction and speed of the camera.
+
+  Returns FALSE if the camera is still.
+*/
+EXPORT BOOL CameraGetPrefetch(struct CAMERA* camera, WORD* firstColumn, WORD* lastColumn)
+{
+  WORD left, right, distance;
+
+  if (camera->cm_Speed == 0)
+  {
+    return FALSE;
+  }
+
+  distance = camera->cm_Speed * CAMERA_PREFETCH_FRAMES;
+
+  if (distance > 0)
+  {
+    left = camera->cm_X + camera->cm_ViewWidth;
+    right = left + distance;
+
+    if (right > camera->cm_Max + camera->cm_ViewWidth)
+    {
+      right = camera->cm_Max + camera->cm_ViewWidth;
+    }
+  }
+  else
+  {
+    right = camera->cm_X;
+    left = right + distance;
+
+    if (left < 0)
+    {
+      left = 0;
+    }
+  }
+
+  if (left >= right)
+  {
+    return FALSE;
+  }
+
+  *firstColumn = left >> 3;
+  *lastColumn = (right - 1) >> 3;
+
+  return TRUE;
+}
@@ -0,0 +1,281 @@
+/**
+    $Id: Clock.c, 1.0 2026/10/19 12:00:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Requester.h>
+#include <Parrot/String.h>
+#include <Parrot/Input.h>
+#include <Parrot/Clock.h>
+
+#include <proto/exec.h>
+#include <proto/timer.h>
+
+#include <exec/interrupts.h>
+#include <hardware/intbits.h>
+#include <devices/timer.h>
+
+#include <Parrot/Private/SDI_interrupt.h>
+
+/*
+    The game task sleeps between frames. A vertical blank interrupt server counts frames and
+    signals the game task, and the input handler signals it when it queues an event.
+
+    Each vertical blank is one logic tick. Frames are timed with the EClock, and when the
+    game falls behind drawing is skipped (up to MAX_RENDER_SKIP frames in a row) so the logic
+    can catch up and keeps the same pace on every machine.
+*/
+
+struct Device*        TimerBase = NULL;
+
+STATIC struct Task*   ClockTask = NULL;
+STATIC BYTE           ClockFrameSignal = -1;
+STATIC BYTE           ClockInputSignal = -1;
+STATIC volatile ULONG ClockVBlanks;
+STATIC ULONG          ClockVBlanksSeen;
+STATIC BOOL           ClockServerAdded = FALSE;
+STATIC struct timerequest ClockTimerReq;
+STATIC ULONG          ClockEFreq;
+STATIC ULONG          ClockFrameStart;
+STATIC ULONG          ClockFrameTicks;
+STATIC UWORD          ClockSkipped;
+STATIC struct CLOCK_STATS ClockStats;
+
+INTERRUPTPROTO(vblankfunc, ULONG, APTR custom, APTR data)
+{
+  ClockVBlanks++;
+  Signal(ClockTask, 1UL << ClockFrameSignal);
+
+  return 0;
+}
+
+MakeInterruptPri(VBlankServer, vblankfunc, "ParrotClock", NULL, 0);
+
+EXPORT VOID ClockInitialise()
+{
+  struct EClockVal now;
+
+  ClockTask = FindTask(NULL);
+  ClockVBlanks = 0;
+  ClockVBlanksSeen = 0;
+  ClockFrameTicks = 0;
+  ClockSkipped = 0;
+  FillMem((UBYTE*) &ClockStats, sizeof(ClockStats), 0);
+
+  if (OpenDevice(TIMERNAME, UNIT_ECLOCK, (struct IORequest*) &ClockTimerReq, 0) != 0)
+  {
+    PARROT_ERR(
+      "Unable to start Clock!\n"
+      "Reason: Could not open timer.device"
+      PARROT_ERR_STR("Device"),
+      TIMERNAME
+    );
+    return;
+  }
+
+  TimerBase = ClockTimerReq.tr_node.io_Device;
+  ClockEFreq = ReadEClock(&now);
+  ClockFrameStart = now.ev_lo;
+
+  ClockFrameSignal = AllocSignal(-1);
+  ClockInputSignal = AllocSignal(-1);
+
+  if (ClockFrameSignal == -1 || ClockInputSignal == -1)
+  {
+    PARROT_ERR(
+      "Unable to start Clock!\n"
+      "Reason: No free signals"
+      PARROT_ERR_INT("Frame Signal")
+      PARROT_ERR_INT("Input Signal"),
+      (LONG) ClockFrameSignal,
+      (LONG) ClockInputSignal
+    );
+    return;
+  }
+
+  InputSetSignal(ClockTask, 1UL << ClockInputSignal);
+
+  AddIntServer(INTB_VERTB, &VBlankServer);
+  ClockServerAdded = TRUE;
+}
+
+EXPORT VOID ClockShutdown()
+{
+  if (ClockServerAdded)
+  {
+    RemIntServer(INTB_VERTB, &VBlankServer);
+    ClockServerAdded = FALSE;
+  }
+
+  InputSetSignal(NULL, 0);
+
+  if (ClockInputSignal != -1)
+  {
+    FreeSignal(ClockInputSignal);
+    ClockInputSignal = -1;
+  }
+
+  if (ClockFrameSignal != -1)
+  {
+    FreeSignal(ClockFrameSignal);
+    ClockFrameSignal = -1;
+  }
+
+  if (TimerBase != NULL)
+  {
+    CloseDevice((struct IORequest*) &ClockTimerReq);
+    TimerBase = NULL;
+  }
+}
+
+/*
+  The low longword of the EClock, only for measuring differences.
+*/
+EXPORT ULONG ClockNow()
+{
+  struct EClockVal now;
+
+  if (TimerBase == NULL)
+  {
+    return 0;
+  }
+
+  ReadEClock(&now);
+
+  return now.ev_lo;
+}
+
+/*
+  Whole milliseconds are divided out before multiplying, so the result does not overflow
+  until the measurement is over an hour long.
+*/
+EXPORT ULONG ClockMicros(ULONG start, ULONG end)
+{
+  ULONG ticks, perMs;
+
+  if (ClockEFreq < 1000)
+  {
+    return 0;
+  }
+
+  ticks = end - start;
+  perMs = ClockEFreq / 1000;
+
+  return (ticks / perMs) * 1000 + ((ticks % perMs) * 1000) / perMs;
+}
+
+/*
+  Sleeps until input arrives or the next vertical blank, unless a frame has already passed.
+
+  Returns the number of frames since the last call, which is 0 when only woken for input.
+*/
+EXPORT ULONG ClockWait()
+{
+  ULONG vblanks, frames;
+
+  if (ClockVBlanks == ClockVBlanksSeen)
+  {
+    Wait((1UL << ClockFrameSignal) | (1UL << ClockInputSignal));
+  }
+
+  vblanks = ClockVBlanks;
+  frames = vblanks - ClockVBlanksSeen;
+  ClockVBlanksSeen = vblanks;
+
+  return frames;
+}
+
+/*
+  Starts a frame, waiting for it unless told not to. Returns the logic ticks to run, which
+  is 0 when only woken for input.
+*/
+EXPORT ULONG ClockBeginFrame(BOOL wait)
+{
+  ULONG ticks;
+
+  if (wait)
+  {
+    ticks = ClockWait();
+  }
+  else
+  {
+    ticks = 1;
+  }
+
+  if (ticks > MAX_FRAME_CATCHUP)
+  {
+    ticks = MAX_FRAME_CATCHUP;
+  }
+
+  ClockFrameTicks = ticks;
+  ClockStats.cs_Ticks += ticks;
+  ClockFrameStart = ClockNow();
+
+  return ticks;
+}
+
+/*
+  More than one tick passed since the last frame, so the last one overran. Drawing is
+  skipped to catch up, but never for more than MAX_RENDER_SKIP frames in a row.
+*/
+EXPORT BOOL ClockShouldRender()
+{
+  if (ClockFrameTicks > 1 && ClockSkipped < MAX_RENDER_SKIP)
+  {
+    ClockSkipped++;
+    ClockStats.cs_Skipped++;
+    return FALSE;
+  }
+
+  ClockSkipped = 0;
+
+  return TRUE;
+}
+
+EXPORT VOID ClockEndFrame(BOOL rendered)
+{
+  ULONG time;
+
+  time = ClockMicros(ClockFrameStart, ClockNow());
+
+  ClockStats.cs_FrameTime = time;
+  ClockStats.cs_FrameTimeAvg = ClockStats.cs_FrameTimeAvg - (ClockStats.cs_FrameTimeAvg >> 4) + (time >> 4);
+
+  if (time > ClockStats.cs_FrameTimeMax)
+  {
+    ClockStats.cs_FrameTimeMax = time;
+  }
+
+  if (rendered)
+  {
+    ClockStats.cs_Frames++;
+  }
+}
+
+EXPORT VOID ClockGetStats(struct CLOCK_STATS* stats)
+{
+  *stats = ClockStats;
+}
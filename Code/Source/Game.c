@@ -34,6 +34,8 @@
 #include <Parrot/String.h>
 #include <Parrot/Graphics.h>
 #include <Parrot/Input.h>
+#include <Parrot/Clock.h>
+#include <Parrot/Log.h>
 
 #include "Asset.h"
 
@@ -76,7 +78,7 @@ STATIC VOID Load(STRPTR path)
     );
   }
 
-  GamePalette = LoadAssetT(struct PALETTE_TABLE, ArenaGame, ARCHIVE_UNKNOWN, CT_PALETTE, GameInfo->gi_StartPalette, CHUNK_FLAG_ARCH_AGA);
+  GamePalette = LoadAssetT(struct PALETTE_TABLE, ArenaGame, ARCHIVE_UNKNOWN, CT_PALETTE, GameInfo->gi_StartPalette, GfxGetArch());
 
   if (NULL == GamePalette)
   {
@@ -97,6 +99,48 @@ STATIC VOID Load(STRPTR path)
 
 }
 
+/*
+    The converter stores the most memory any room needs in GAME_INFO, so the arenas are
+    opened at that size and the game can refuse to start when there is not enough memory.
+    Older archives without a budget get DEFAULT_ARENA_SIZE.
+*/
+STATIC ULONG ArenaBudget(ULONG size)
+{
+  return size == 0 ? DEFAULT_ARENA_SIZE : size;
+}
+
+STATIC VOID CheckMemory()
+{
+  ULONG arena, chip, largest, total, chipTotal;
+
+  arena = ArenaBudget(GameInfo->gi_RoomArena) + ArenaBudget(GameInfo->gi_ChapterArena) + GameInfo->gi_TableArena;
+  chip = GameInfo->gi_RoomChip;
+
+  largest = AvailMem(MEMF_ANY | MEMF_LARGEST);
+  total = AvailMem(MEMF_ANY);
+  chipTotal = AvailMem(MEMF_CHIP);
+
+  LOG_INFO("Budget room %ld chapter %ld chip %ld", ArenaBudget(GameInfo->gi_RoomArena), ArenaBudget(GameInfo->gi_ChapterArena), chip);
+
+  if (chipTotal < chip || total < arena + chip || largest < ArenaBudget(GameInfo->gi_RoomArena))
+  {
+    PARROT_ERR(
+      "Not enough memory to play this game!\n"
+      "Reason: The largest room needs more memory than is free"
+      PARROT_ERR_STR("Game")
+      PARROT_ERR_INT("Memory needed")
+      PARROT_ERR_INT("Memory free")
+      PARROT_ERR_INT("Chip needed")
+      PARROT_ERR_INT("Chip free"),
+      &GameInfo->gi_Title[0],
+      arena + chip,
+      total,
+      chip,
+      chipTotal
+    );
+  }
+}
+
 EXPORT VOID GameStart(STRPTR path)
 {
   struct SCREEN_INFO screenInfo;
@@ -116,12 +160,11 @@ EXPORT VOID GameStart(STRPTR path)
   ArenaGame = NULL;
   ArenaChapter = NULL;
   ArenaRoom = NULL;
+  ArenaTables = NULL;
 
   InitStackVar(struct UNPACKED_ROOM, uroom);
 
   ArenaGame = ArenaOpen(16384, MEMF_CLEAR);
-  ArenaChapter = ArenaOpen(131072, MEMF_CLEAR);
-  ArenaRoom = ArenaOpen(131072, MEMF_CLEAR);
 
   InitialiseArchives(path);
 
@@ -141,6 +184,17 @@ EXPORT VOID GameStart(STRPTR path)
 
   CloseArchive(0);
 
+  CheckMemory();
+
+  ArenaChapter = ArenaOpen(ArenaBudget(GameInfo->gi_ChapterArena), MEMF_CLEAR);
+  ArenaRoom = ArenaOpen(ArenaBudget(GameInfo->gi_RoomArena), MEMF_CLEAR);
+
+  /* Object tables too large for the start tables go on in these */
+  if (0 != GameInfo->gi_TableArena)
+  {
+    ArenaTables = ArenaOpen(GameInfo->gi_TableArena, MEMF_CLEAR);
+  }
+
 #if 0
 
   screenInfo.si_Width = GameInfo->gi_Width;
@@ -192,18 +246,22 @@ EXPORT VOID GameStart(STRPTR path)
   ArenaRollback(ArenaChapter);
 
   InputInitialise();
+  ClockInitialise();
 
   entrance.en_Room = 3; // GameInfo->gi_StartRoom;
   entrance.en_Exit = 0;
 
   while (entrance.en_Room != 0 && InEvtForceQuit == FALSE)
   {
+    /* Each room reloads its ROOM asset into ArenaChapter */
+    ArenaRollback(ArenaChapter);
     ArenaRollback(ArenaRoom);
 
     /* Start First Room */
     PlayRoom(0, &entrance, GameInfo);
   }
 
+  ClockShutdown();
   InputExit();
 
   GfxHide();
@@ -212,6 +270,11 @@ EXPORT VOID GameStart(STRPTR path)
 #endif
   CloseArchives();
 
+  if (NULL != ArenaTables)
+  {
+    ArenaClose(ArenaTables);
+  }
+
   ArenaClose(ArenaRoom);
   ArenaClose(ArenaChapter);
   ArenaClose(ArenaGame);
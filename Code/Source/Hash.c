@@ -0,0 +1,64 @@
+/**
+    $Id: Hash.c, 1.0 2026/10/19 15:40:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Hash.h>
+
+/*
+    32-bit FNV-1a. A hash is started from HASH_SEED and each call carries on from the hash
+    it is given, so several pieces of data can be hashed as if they were one.
+*/
+
+#define HASH_PRIME 0x01000193UL
+
+EXPORT ULONG HashBytes(CONST VOID* pData, ULONG length, ULONG hash)
+{
+  CONST UBYTE* data;
+
+  data = (CONST UBYTE*) pData;
+
+  while (length--)
+  {
+    hash ^= *data++;
+    hash *= HASH_PRIME;
+  }
+
+  return hash;
+}
+
+/* Hashes the value most significant byte first, so the result is the same on any machine */
+EXPORT ULONG HashULONG(ULONG value, ULONG hash)
+{
+  UBYTE bytes[4];
+
+  bytes[0] = (UBYTE) (value >> 24);
+  bytes[1] = (UBYTE) (value >> 16);
+  bytes[2] = (UBYTE) (value >> 8);
+  bytes[3] = (UBYTE) value;
+
+  return HashBytes(bytes, 4, hash);
+}
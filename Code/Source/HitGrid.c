@@ -0,0 +1,155 @@
+/**
+    $Id: HitGrid.c, 1.0 2026/10/19 11:20:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Arena.h>
+#include <Parrot/HitGrid.h>
+
+/*
+    The room is divided into 8x8 pixel cells, matching the Maniac Mansion object coordinates.
+    Each cell holds a bitmask of every exit and entity whose hitbox touches it, so finding what
+    is under the cursor is a single lookup followed by a check of only those hitboxes.
+
+    The grid is built in ArenaRoom when the room entities are unpacked.
+*/
+
+STATIC BOOL PointInside(struct RECT* rect, WORD x, WORD y)
+{
+  return x >= rect->rt_Left && x <= rect->rt_Right && y >= rect->rt_Top && y <= rect->rt_Bottom;
+}
+
+STATIC VOID MarkRect(struct UNPACKED_ROOM* room, struct RECT* rect, ULONG bit)
+{
+  WORD left, top, right, bottom, x, y;
+  ULONG* row;
+
+  left = rect->rt_Left >> HIT_CELL_SHIFT;
+  top = rect->rt_Top >> HIT_CELL_SHIFT;
+  right = rect->rt_Right >> HIT_CELL_SHIFT;
+  bottom = rect->rt_Bottom >> HIT_CELL_SHIFT;
+
+  if (left < 0)
+    left = 0;
+
+  if (top < 0)
+    top = 0;
+
+  if (right >= (WORD) room->ur_HitCols)
+    right = room->ur_HitCols - 1;
+
+  if (bottom >= (WORD) room->ur_HitRows)
+    bottom = room->ur_HitRows - 1;
+
+  for (y = top; y <= bottom; y++)
+  {
+    row = room->ur_HitGrid + (ULONG) y * room->ur_HitCols;
+
+    for (x = left; x <= right; x++)
+    {
+      row[x] |= bit;
+    }
+  }
+}
+
+EXPORT VOID HitGridBuild(struct UNPACKED_ROOM* room)
+{
+  struct ENTITY* entity;
+  UWORD ii;
+
+  room->ur_HitCols = (room->ur_Room->rm_Width + HIT_CELL_SIZE - 1) >> HIT_CELL_SHIFT;
+  room->ur_HitRows = (room->ur_Room->rm_Height + HIT_CELL_SIZE - 1) >> HIT_CELL_SHIFT;
+  room->ur_HitGrid = NewObject(ArenaRoom, (ULONG) room->ur_HitCols * room->ur_HitRows * sizeof(ULONG), TRUE);
+
+  if (NULL == room->ur_HitGrid)
+  {
+    return;
+  }
+
+  for (ii = 0; ii < MAX_ROOM_EXITS; ii++)
+  {
+    entity = (struct ENTITY*) room->ur_Exits[ii];
+
+    if (NULL != entity)
+    {
+      MarkRect(room, &entity->en_HitBox, HIT_EXIT_BIT(ii));
+    }
+  }
+
+  for (ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
+  {
+    entity = (struct ENTITY*) room->ur_Entities[ii];
+
+    if (NULL != entity)
+    {
+      MarkRect(room, &entity->en_HitBox, HIT_ENTITY_BIT(ii));
+    }
+  }
+}
+
+/*
+  Exits take priority over entities, and lower slots over higher ones.
+*/
+EXPORT struct ENTITY* HitGridFind(struct UNPACKED_ROOM* room, WORD x, WORD y)
+{
+  struct ENTITY* entity;
+  ULONG mask;
+  UWORD ii;
+
+  if (NULL == room->ur_HitGrid || x < 0 || y < 0)
+  {
+    return NULL;
+  }
+
+  if ((x >> HIT_CELL_SHIFT) >= room->ur_HitCols || (y >> HIT_CELL_SHIFT) >= room->ur_HitRows)
+  {
+    return NULL;
+  }
+
+  mask = room->ur_HitGrid[(ULONG) (y >> HIT_CELL_SHIFT) * room->ur_HitCols + (x >> HIT_CELL_SHIFT)];
+
+  for (ii = 0; mask != 0 && ii < MAX_ROOM_EXITS + MAX_ROOM_ENTITIES; ii++, mask >>= 1)
+  {
+    if ((mask & 1) == 0)
+      continue;
+
+    if (ii < MAX_ROOM_EXITS)
+    {
+      entity = (struct ENTITY*) room->ur_Exits[ii];
+    }
+    else
+    {
+      entity = (struct ENTITY*) room->ur_Entities[ii - MAX_ROOM_EXITS];
+    }
+
+    if (NULL != entity && PointInside(&entity->en_HitBox, x, y))
+    {
+      return entity;
+    }
+  }
+
+  return NULL;
+}
@@ -48,7 +48,7 @@ EXPORT VOID UnpackBitmap(APTR asset, struct IFFHandle* iff)
 
   for (ii = 0; ii < img->im_Depth; ii++)
   {
-    img->im_Planes[ii] = (PLANEPTR) AllocRaster(img->im_Width, img->im_Height);
+    img->im_Planes[ii] = (PLANEPTR) AllocRaster(img->im_BytesPerRow << 3, img->im_Height);
 
     if (img->im_Planes[ii] == NULL)
     {
@@ -68,6 +68,28 @@ EXPORT VOID UnpackBitmap(APTR asset, struct IFFHandle* iff)
     ReadChunkBytes(iff, img->im_Planes[ii], img->im_PlaneSize);
   }
 
+  img->im_Mask = NULL;
+
+  if ((img->im_Options & IMO_MASK) != 0)
+  {
+    img->im_Mask = (UBYTE*) AllocRaster(img->im_BytesPerRow << 3, img->im_Height);
+
+    if (img->im_Mask == NULL)
+    {
+      PARROT_ERR(
+        "Out of Memory!\n"
+        "Reason: No Chip Memory available for Mask"
+        PARROT_ERR_INT("IMAGE::im_Width")
+        PARROT_ERR_INT("IMAGE::im_Height"),
+        img->im_Width, img->im_Height
+      );
+
+      goto CLEAN_EXIT;
+    }
+
+    ReadChunkBytes(iff, img->im_Mask, img->im_PlaneSize);
+  }
+
   CLEAN_EXIT:
 }
 
@@ -82,8 +104,14 @@ EXPORT VOID PackBitmap(APTR asset)
   {
     for (ii = 0; ii < img->im_Depth; ii++)
     {
-      FreeRaster(img->im_Planes[ii], img->im_Width, img->im_Height);
+      FreeRaster(img->im_Planes[ii], img->im_BytesPerRow << 3, img->im_Height);
       img->im_Planes[ii] = NULL;
     }
   }
+
+  if (img->im_Mask != NULL)
+  {
+    FreeRaster((PLANEPTR) img->im_Mask, img->im_BytesPerRow << 3, img->im_Height);
+    img->im_Mask = NULL;
+  }
 }
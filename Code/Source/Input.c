@@ -32,6 +32,7 @@
 #include <proto/exec.h>
 #include <proto/input.h>
 #include <proto/graphics.h>
+#include <proto/dos.h>
 
 #include <clib/alib_protos.h>
 
@@ -44,8 +45,42 @@
 
 #include <Parrot/Private/SDI_interrupt.h>
 
+/*
+    Input events are passed from the input handler to the game through a single producer,
+    single consumer ring. Only the handler writes InputWrite and only PopEvent writes
+    InputRead, so no locking is needed. When the ring is full the event is dropped and
+    counted in InputOverflows.
+
+    Cursor movement is not queued per move. Consecutive moves share one IET_CURSOR marker,
+    whose position is kept beside the ring in InputCursors as one longword so it is never
+    read half written. The handler updates it for as long as the marker is the last event
+    queued, so a move after a button event gets its own marker.
+*/
+
 struct INPUTEVENT Inputs[MAX_INPUT_EVENT_SIZE] = { 0 };
-UWORD InputWrite, InputRead;
+volatile UWORD InputWrite, InputRead;
+volatile ULONG InputCursors[MAX_INPUT_EVENT_SIZE];
+ULONG InputOverflows;
+ULONG InputFrame;
+
+/*
+    Recording writes every event given to the game with the frame it was given on. Replaying
+    gives the game those events on the same frames instead of live input, and quits at the
+    end. Both are turned on with environment variables:
+
+      Parrot/Record      Path of a recording to write
+      Parrot/Replay      Path of a recording to replay
+      Parrot/ReplayFast  Set to 1 to replay without waiting for the display
+*/
+
+STATIC BPTR  RecordFile = 0;
+STATIC BPTR  ReplayFile = 0;
+STATIC BOOL  ReplayFast = FALSE;
+STATIC BOOL  ReplayHasNext = FALSE;
+STATIC struct INPUT_RECORD ReplayNext;
+
+STATIC struct Task* InputTask = NULL;
+STATIC ULONG InputSignalMask = 0;
 
 UWORD CursorSelect[2], CursorMenu[2];
 
@@ -60,43 +95,272 @@ EXTERN WORD CursorY;
 EXTERN WORD CursorXLimit;
 EXTERN WORD CursorYLimit;
 
-#define SemAcquireInputRw()
-#define SemReleaseInputRw() 
+STATIC VOID RecordEvent(struct INPUTEVENT* ie)
+{
+  struct INPUT_RECORD record;
+
+  record.ir_Frame = InputFrame;
+  record.ir_Event = *ie;
+
+  FWrite(RecordFile, &record, sizeof(struct INPUT_RECORD), 1);
+}
+
+STATIC VOID ReplayEnd()
+{
+  Close(ReplayFile);
+  ReplayFile = 0;
+  ReplayHasNext = FALSE;
+  InEvtForceQuit = TRUE;
+}
+
+/*
+  Applies the cursor, button and key state a replayed event would have set in the input
+  handler. The handler leaves this state alone whilst replaying.
+*/
+STATIC VOID ReplayState(struct INPUTEVENT* ie)
+{
+  switch (ie->ie_Type)
+  {
+    case IET_KEYDOWN:
+      KeyState[ie->ie_Code & 0xFF] = 1;
+    break;
+    case IET_KEYUP:
+      KeyState[ie->ie_Code & 0xFF] = 0;
+    break;
+    case IET_CURSOR:
+      CursorX = ie->ie_CursX;
+      CursorY = ie->ie_CursY;
+      MoveSprite(NULL, &CursorSprite, CursorX + CursorOffsetX, CursorY + CursorOffsetY);
+    break;
+    case IET_SELECTDOWN:
+      CursorSelect[0] = CursorSelect[1];
+      CursorSelect[1] = TRUE;
+    break;
+    case IET_SELECTUP:
+      CursorSelect[0] = CursorSelect[1];
+      CursorSelect[1] = FALSE;
+    break;
+    case IET_MENUDOWN:
+      CursorMenu[0] = CursorMenu[1];
+      CursorMenu[1] = TRUE;
+    break;
+    case IET_MENUUP:
+      CursorMenu[0] = CursorMenu[1];
+      CursorMenu[1] = FALSE;
+    break;
+  }
+}
+
+STATIC BOOL ReplayEvent(struct INPUTEVENT* ie)
+{
+  if (ReplayHasNext == FALSE)
+  {
+    if (FRead(ReplayFile, &ReplayNext, sizeof(struct INPUT_RECORD), 1) != 1)
+    {
+      ReplayEnd();
+      return FALSE;
+    }
+
+    ReplayHasNext = TRUE;
+  }
+
+  if (ReplayNext.ir_Frame > InputFrame)
+  {
+    return FALSE;
+  }
+
+  *ie = ReplayNext.ir_Event;
+  ReplayHasNext = FALSE;
+
+  ReplayState(ie);
+
+  return TRUE;
+}
 
 BOOL PopEvent(struct INPUTEVENT* ie)
 {
   struct INPUTEVENT* popped;
-  BOOL rc;
+  UWORD read;
+  ULONG cursor;
+
+  if (ReplayFile != 0)
+  {
+    return ReplayEvent(ie);
+  }
+
+  read = InputRead;
+
+  if (InputWrite == read)
+  {
+    return FALSE;
+  }
+
+  popped = &Inputs[read];
+  ie->ie_Type = popped->ie_Type;
+  ie->ie_Code = popped->ie_Code;
+  ie->ie_CursX = popped->ie_CursX;
+  ie->ie_CursY = popped->ie_CursY;
+
+  /*
+    The cursor marker is retired before its position is read, see PushCursor. A handler
+    that runs in between then either pushes a new marker or has already stored the
+    position read here.
+  */
+  InputRead = (read + 1) & (MAX_INPUT_EVENT_SIZE - 1);
+
+  if (ie->ie_Type == IET_CURSOR)
+  {
+    cursor = InputCursors[read];
+    ie->ie_CursX = (WORD) (cursor >> 16);
+    ie->ie_CursY = (WORD) (cursor & 0xFFFF);
+  }
+
+  if (RecordFile != 0)
+  {
+    RecordEvent(ie);
+  }
+
+  return TRUE;
+}
+
+/*
+  The task is signalled whenever the input handler queues new events.
+*/
+EXPORT VOID InputSetSignal(struct Task* task, ULONG signalMask)
+{
+  Forbid();
+  InputTask = task;
+  InputSignalMask = signalMask;
+  Permit();
+}
+
+EXPORT VOID InputNextFrame()
+{
+  InputFrame++;
+}
+
+EXPORT BOOL InputIsReplayingFast()
+{
+  return ReplayFile != 0 && ReplayFast;
+}
 
-  rc = FALSE;
+STATIC VOID OpenRecording()
+{
+  CHAR  path[256];
+  ULONG header[2];
 
-  if (InputWrite != InputRead)
+  if (GetVar("Parrot/Replay", path, sizeof(path), 0) > 0)
   {
-    popped = &Inputs[InputRead];
-    ie->ie_Type = popped->ie_Type;
-    ie->ie_Code = popped->ie_Code;
-    ie->ie_CursX = popped->ie_CursX;
-    ie->ie_CursY = popped->ie_CursY;
-    rc = TRUE;
-
-    InputRead = (InputRead + 1) & (MAX_INPUT_EVENT_SIZE - 1);
+    ReplayFile = Open(path, MODE_OLDFILE);
+
+    if (ReplayFile != 0)
+    {
+      if (FRead(ReplayFile, header, sizeof(header), 1) != 1 || header[0] != INPUT_RECORDING_ID || header[1] != INPUT_RECORDING_VERSION)
+      {
+        Close(ReplayFile);
+        ReplayFile = 0;
+      }
+    }
+
+    ReplayFast = GetVar("Parrot/ReplayFast", path, sizeof(path), 0) > 0 && path[0] == '1';
+    ReplayHasNext = FALSE;
+
+    return;
   }
 
+  if (GetVar("Parrot/Record", path, sizeof(path), 0) > 0)
+  {
+    RecordFile = Open(path, MODE_NEWFILE);
 
-  return rc;
+    if (RecordFile != 0)
+    {
+      header[0] = INPUT_RECORDING_ID;
+      header[1] = INPUT_RECORDING_VERSION;
+      FWrite(RecordFile, header, sizeof(header), 1);
+    }
+  }
 }
 
-VOID PushEvent(struct INPUTEVENT* ie)
+STATIC VOID CloseRecording()
+{
+  if (RecordFile != 0)
+  {
+    Close(RecordFile);
+    RecordFile = 0;
+  }
+
+  if (ReplayFile != 0)
+  {
+    Close(ReplayFile);
+    ReplayFile = 0;
+  }
+}
+
+STATIC BOOL PushEvent(struct INPUTEVENT* ie)
 {
   struct INPUTEVENT* pushed;
+  UWORD write, next;
 
-  pushed = &Inputs[InputWrite];
+  write = InputWrite;
+  next = (write + 1) & (MAX_INPUT_EVENT_SIZE - 1);
+
+  if (next == InputRead)
+  {
+    InputOverflows++;
+    return FALSE;
+  }
+
+  pushed = &Inputs[write];
   pushed->ie_Type = ie->ie_Type;
   pushed->ie_Code = ie->ie_Code;
   pushed->ie_CursX = ie->ie_CursX;
   pushed->ie_CursY = ie->ie_CursY;
 
-  InputWrite = (InputWrite + 1) & (MAX_INPUT_EVENT_SIZE - 1);
+  InputWrite = next;
+
+  return TRUE;
+}
+
+/*
+  Moves the last queued marker if it is still in the ring, otherwise queues a new one.
+
+  The position is stored in the marker before checking that the game has not read it, and
+  PopEvent retires a marker before reading its position. If the game retires the marker
+  after the position is stored it reads the new position, and if it retired it before then
+  the ring no longer holds it and a new marker is pushed.
+*/
+STATIC VOID PushCursor(WORD x, WORD y)
+{
+  struct INPUTEVENT evt;
+  ULONG cursor;
+  UWORD write, last;
+
+  cursor = (((ULONG) (UWORD) x) << 16) | (UWORD) y;
+
+  write = InputWrite;
+
+  if (write != InputRead)
+  {
+    last = (write - 1) & (MAX_INPUT_EVENT_SIZE - 1);
+
+    if (Inputs[last].ie_Type == IET_CURSOR)
+    {
+      InputCursors[last] = cursor;
+
+      if (write != InputRead)
+      {
+        return;
+      }
+    }
+  }
+
+  InputCursors[write] = cursor;
+
+  evt.ie_Type = IET_CURSOR;
+  evt.ie_Code = 0;
+  evt.ie_CursX = x;
+  evt.ie_CursY = y;
+  PushEvent(&evt);
 }
 
 HANDLERPROTO(handlerfunc, ULONG, struct InputEvent* ie, APTR userdata)
@@ -104,8 +368,20 @@ HANDLERPROTO(handlerfunc, ULONG, struct InputEvent* ie, APTR userdata)
   struct INPUTEVENT evt;
   BOOL hasMouseUpdate;
   WORD mouseX, mouseY, selectDown, selectUp, menuDown, menuUp;
+  UWORD write;
 
+  /* Live input is thrown away whilst replaying, the game only sees the recording */
+  if (ReplayFile != 0)
+  {
+    return 0;
+  }
+
+  write = InputWrite;
   hasMouseUpdate = FALSE;
+  selectDown = FALSE;
+  selectUp = FALSE;
+  menuDown = FALSE;
+  menuUp = FALSE;
   mouseX = CursorX;
   mouseY = CursorY;
 
@@ -191,11 +467,7 @@ HANDLERPROTO(handlerfunc, ULONG, struct InputEvent* ie, APTR userdata)
 
     MoveSprite(NULL, &CursorSprite, CursorX + CursorOffsetX, CursorY + CursorOffsetY);
 
-    evt.ie_Type = IET_CURSOR;
-    evt.ie_Code = 0;
-    evt.ie_CursX = CursorX;
-    evt.ie_CursY = CursorY;
-    PushEvent(&evt);
+    PushCursor(CursorX, CursorY);
   }
 
   if (selectDown == TRUE)
@@ -265,6 +537,11 @@ HANDLERPROTO(handlerfunc, ULONG, struct InputEvent* ie, APTR userdata)
     }
   }
 
+  if (write != InputWrite && InputTask != NULL)
+  {
+    Signal(InputTask, InputSignalMask);
+  }
+
   return 0;
 }
 
@@ -281,10 +558,15 @@ EXPORT VOID InputInitialise()
   InEvtForceQuit = FALSE;
   InEvtKey = 0;
   InputRead = 0;
-  InputWrite = 1;
+  InputWrite = 0;
+  InputOverflows = 0;
+  InputFrame = 0;
   CursorX = 0;
   CursorY = 0;
 
+  /* Before the handler is added, so it never touches the cursor of a replay */
+  OpenRecording();
+
   KeyMsgPort = CreateMsgPort();
   KeyIOReq = (struct IOStdReq*) CreateExtIO(KeyMsgPort, sizeof(struct IOStdReq));
 
@@ -328,6 +610,8 @@ EXPORT VOID InputExit()
   {
     DeleteMsgPort(KeyMsgPort);
   }
+
+  CloseRecording();
 }
 
 EXPORT BOOL IsMenuDown()
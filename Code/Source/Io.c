@@ -0,0 +1,458 @@
+/**
+    $Id: Io.c, 1.0 2026/10/19 14:20:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/String.h>
+#include <Parrot/Io.h>
+
+#if defined(IS_M68K)
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <dos/dos.h>
+#endif
+
+/*
+    Whole file reading and an IFF writer that build on the Amiga and on a host computer.
+
+    The writer keeps the whole FORM in memory and writes it to the file when it is closed,
+    so chunk sizes never have to be known in advance and no seeking is needed. Numbers are
+    always written big-endian, and odd sized chunks get a pad byte the same as iffparse, so
+    a file is byte for byte the same wherever it was written.
+*/
+
+#define IFF_INITIAL_CAPACITY 65536
+
+#if defined(IS_M68K)
+
+EXPORT UBYTE* IoReadFile(CONST CHAR* path, ULONG* size)
+{
+  BPTR   file;
+  LONG   len;
+  UBYTE* data;
+
+  data = NULL;
+  *size = 0;
+
+  file = Open((STRPTR) path, MODE_OLDFILE);
+
+  if (0 == file)
+  {
+    goto CLEAN_EXIT;
+  }
+
+  Seek(file, 0, OFFSET_END);
+  len = Seek(file, 0, OFFSET_BEGINNING);
+
+  if (len <= 0)
+  {
+    goto CLEAN_EXIT;
+  }
+
+  data = AllocVec(len, 0);
+
+  if (NULL == data)
+  {
+    goto CLEAN_EXIT;
+  }
+
+  if (Read(file, data, len) != len)
+  {
+    FreeVec(data);
+    data = NULL;
+    goto CLEAN_EXIT;
+  }
+
+  *size = len;
+
+CLEAN_EXIT:
+
+  if (0 != file)
+  {
+    Close(file);
+  }
+
+  return data;
+}
+
+STATIC BOOL IoWriteFile(CONST CHAR* path, CONST UBYTE* data, ULONG size)
+{
+  BPTR file;
+  BOOL written;
+
+  file = Open((STRPTR) path, MODE_NEWFILE);
+
+  if (0 == file)
+  {
+    return FALSE;
+  }
+
+  written = Write(file, (APTR) data, size) == size;
+
+  Close(file);
+
+  return written;
+}
+
+EXPORT BOOL IoFileExists(CONST CHAR* path)
+{
+  BPTR lock;
+
+  lock = Lock((STRPTR) path, ACCESS_READ);
+
+  if (0 == lock)
+  {
+    return FALSE;
+  }
+
+  UnLock(lock);
+
+  return TRUE;
+}
+
+#else
+
+EXPORT UBYTE* IoReadFile(CONST CHAR* path, ULONG* size)
+{
+  FILE*  file;
+  long   len;
+  UBYTE* data;
+
+  data = NULL;
+  *size = 0;
+
+  file = fopen(path, "rb");
+
+  if (NULL == file)
+  {
+    goto CLEAN_EXIT;
+  }
+
+  fseek(file, 0, SEEK_END);
+  len = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  if (len <= 0)
+  {
+    goto CLEAN_EXIT;
+  }
+
+  data = AllocVec(len, 0);
+
+  if (NULL == data)
+  {
+    goto CLEAN_EXIT;
+  }
+
+  if (fread(data, 1, len, file) != (size_t) len)
+  {
+    FreeVec(data);
+    data = NULL;
+    goto CLEAN_EXIT;
+  }
+
+  *size = len;
+
+CLEAN_EXIT:
+
+  if (NULL != file)
+  {
+    fclose(file);
+  }
+
+  return data;
+}
+
+STATIC BOOL IoWriteFile(CONST CHAR* path, CONST UBYTE* data, ULONG size)
+{
+  FILE* file;
+  BOOL  written;
+
+  file = fopen(path, "wb");
+
+  if (NULL == file)
+  {
+    return FALSE;
+  }
+
+  written = fwrite(data, 1, size, file) == size;
+
+  if (fclose(file) != 0)
+  {
+    written = FALSE;
+  }
+
+  return written;
+}
+
+EXPORT BOOL IoFileExists(CONST CHAR* path)
+{
+  FILE* file;
+
+  file = fopen(path, "rb");
+
+  if (NULL == file)
+  {
+    return FALSE;
+  }
+
+  fclose(file);
+
+  return TRUE;
+}
+
+#endif
+
+EXPORT VOID IoFreeFile(UBYTE* data)
+{
+  if (NULL != data)
+  {
+    FreeVec(data);
+  }
+}
+
+STATIC UBYTE* IffReserve(struct IFF_WRITER* iw, ULONG length)
+{
+  UBYTE* data;
+  ULONG  capacity;
+
+  if (iw->iw_Failed)
+  {
+    return NULL;
+  }
+
+  if (iw->iw_Size + length > iw->iw_Capacity)
+  {
+    capacity = iw->iw_Capacity;
+
+    while (iw->iw_Size + length > capacity)
+    {
+      capacity <<= 1;
+    }
+
+    data = AllocVec(capacity, 0);
+
+    if (NULL == data)
+    {
+      iw->iw_Failed = TRUE;
+      return NULL;
+    }
+
+    CopyMem(iw->iw_Data, data, iw->iw_Size);
+    FreeVec(iw->iw_Data);
+
+    iw->iw_Data = data;
+    iw->iw_Capacity = capacity;
+  }
+
+  data = iw->iw_Data + iw->iw_Size;
+  iw->iw_Size += length;
+
+  return data;
+}
+
+STATIC VOID IffPutULONG(UBYTE* dst, ULONG value)
+{
+  dst[0] = (UBYTE) (value >> 24);
+  dst[1] = (UBYTE) (value >> 16);
+  dst[2] = (UBYTE) (value >> 8);
+  dst[3] = (UBYTE) (value);
+}
+
+EXPORT BOOL IffOpenWriter(struct IFF_WRITER* iw, CONST CHAR* path, ULONG formType)
+{
+  FillMem((UBYTE*) iw, sizeof(struct IFF_WRITER), 0);
+
+  if (StrCopy(iw->iw_Path, sizeof(iw->iw_Path), path) == 0)
+  {
+    return FALSE;
+  }
+
+  iw->iw_Data = AllocVec(IFF_INITIAL_CAPACITY, 0);
+
+  if (NULL == iw->iw_Data)
+  {
+    return FALSE;
+  }
+
+  iw->iw_Capacity = IFF_INITIAL_CAPACITY;
+
+  IffPushChunk(iw, MAKE_NODE_ID('F','O','R','M'));
+  IffWriteULONG(iw, formType);
+
+  return TRUE;
+}
+
+EXPORT BOOL IffCloseWriter(struct IFF_WRITER* iw)
+{
+  BOOL written;
+
+  written = FALSE;
+
+  if (NULL == iw->iw_Data)
+  {
+    return FALSE;
+  }
+
+  while (iw->iw_Depth > 0)
+  {
+    IffPopChunk(iw);
+  }
+
+  if (iw->iw_Failed == FALSE)
+  {
+    written = IoWriteFile(iw->iw_Path, iw->iw_Data, iw->iw_Size);
+  }
+
+  FreeVec(iw->iw_Data);
+  iw->iw_Data = NULL;
+
+  return written;
+}
+
+EXPORT VOID IffPushChunk(struct IFF_WRITER* iw, ULONG id)
+{
+  UBYTE* dst;
+
+  if (iw->iw_Depth >= MAX_IFF_DEPTH)
+  {
+    iw->iw_Failed = TRUE;
+    return;
+  }
+
+  dst = IffReserve(iw, 8);
+
+  if (NULL == dst)
+  {
+    return;
+  }
+
+  IffPutULONG(dst, id);
+  IffPutULONG(dst + 4, 0);
+
+  iw->iw_Chunks[iw->iw_Depth++] = iw->iw_Size - 4;
+}
+
+EXPORT VOID IffPopChunk(struct IFF_WRITER* iw)
+{
+  ULONG start, size;
+
+  if (iw->iw_Depth == 0 || iw->iw_Failed)
+  {
+    return;
+  }
+
+  start = iw->iw_Chunks[--iw->iw_Depth];
+  size = iw->iw_Size - (start + 4);
+
+  IffPutULONG(iw->iw_Data + start, size);
+
+  if ((size & 1) != 0)
+  {
+    IffWriteUBYTE(iw, 0);
+  }
+}
+
+EXPORT VOID IffWriteBytes(struct IFF_WRITER* iw, CONST VOID* data, ULONG length)
+{
+  UBYTE* dst;
+
+  dst = IffReserve(iw, length);
+
+  if (NULL != dst)
+  {
+    CopyMem(data, dst, length);
+  }
+}
+
+EXPORT VOID IffWriteUBYTE(struct IFF_WRITER* iw, UBYTE value)
+{
+  UBYTE* dst;
+
+  dst = IffReserve(iw, 1);
+
+  if (NULL != dst)
+  {
+    dst[0] = value;
+  }
+}
+
+EXPORT VOID IffWriteUWORD(struct IFF_WRITER* iw, UWORD value)
+{
+  UBYTE* dst;
+
+  dst = IffReserve(iw, 2);
+
+  if (NULL != dst)
+  {
+    dst[0] = (UBYTE) (value >> 8);
+    dst[1] = (UBYTE) (value);
+  }
+}
+
+EXPORT VOID IffWriteULONG(struct IFF_WRITER* iw, ULONG value)
+{
+  UBYTE* dst;
+
+  dst = IffReserve(iw, 4);
+
+  if (NULL != dst)
+  {
+    IffPutULONG(dst, value);
+  }
+}
+
+EXPORT VOID IffWriteUWORDs(struct IFF_WRITER* iw, CONST UWORD* data, ULONG count)
+{
+  UBYTE* dst;
+
+  dst = IffReserve(iw, count << 1);
+
+  if (NULL == dst)
+  {
+    return;
+  }
+
+  while (count--)
+  {
+    dst[0] = (UBYTE) (*data >> 8);
+    dst[1] = (UBYTE) (*data);
+    dst += 2;
+    data++;
+  }
+}
+
+EXPORT VOID IffWritePad(struct IFF_WRITER* iw, ULONG length)
+{
+  UBYTE* dst;
+
+  dst = IffReserve(iw, length);
+
+  if (NULL != dst)
+  {
+    FillMem(dst, length, 0);
+  }
+}
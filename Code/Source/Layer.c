@@ -0,0 +1,259 @@
+/**
+    $Id: Layer.c, 1.0 2026/10/19 10:05:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Requester.h>
+#include <Parrot/String.h>
+#include <Parrot/Graphics.h>
+#include <Parrot/Layer.h>
+#include <Parrot/Log.h>
+
+/*
+    Layers are the room backdrops, composited into the room viewport.
+
+    Layer 0 is the room itself and is in front, every further layer is further back and is
+    seen through colour 0 of the layers in front of it. Each layer has a scroll factor in
+    8.8 fixed point; 256 scrolls with the room, less scrolls slower for parallax.
+
+    A single layer is only composited into a display buffer when its position within the
+    room bitmap or its image changes. One that scrolls with the room never changes position,
+    as the scrolling is done by the hardware. With more layers only the visible window is
+    composited, so every move of the camera redraws it.
+
+    Every layer in front of another must have been exported with IMO_MASK. The Maniac
+    converter only writes the one room backdrop, so this path is not used by it yet.
+*/
+
+STATIC struct LAYER  Layers[MAX_ROOM_BACKDROPS];
+STATIC UWORD         LayerCount;
+STATIC WORD          LayerCamX;
+
+STATIC WORD LayerPosition(struct LAYER* layer, WORD camX)
+{
+  return camX - (WORD) ((((LONG) camX) * layer->ly_Factor) >> 8);
+}
+
+STATIC VOID DrawLayerWindow(UWORD vp, struct LAYER* layer, WORD x, WORD w, BOOL masked)
+{
+  struct IMAGE* image;
+  WORD sx, sw;
+
+  image = layer->ly_Image;
+  sx = x - layer->ly_Offset;
+  sw = w;
+
+  if (sx < 0)
+  {
+    x -= sx;
+    sw += sx;
+    sx = 0;
+  }
+
+  if (sx + sw > image->im_Width)
+  {
+    sw = image->im_Width - sx;
+  }
+
+  if (sw <= 0)
+  {
+    return;
+  }
+
+  if (masked)
+  {
+    GfxBlitBitmapMasked(vp, image, image->im_Mask, x, 0, sx, 0, sw, image->im_Height);
+  }
+  else
+  {
+    GfxBlitBitmap(vp, image, x, 0, sx, 0, sw, image->im_Height);
+  }
+}
+
+EXPORT VOID LayersInitialise(struct UNPACKED_ROOM* room)
+{
+  struct LAYER* layer;
+  struct IMAGE* image;
+  UWORD ii;
+
+  FillMem((UBYTE*) &Layers[0], sizeof(Layers), 0);
+
+  LayerCount = 0;
+  LayerCamX = room->ur_CamX;
+
+  for (ii = 0; ii < MAX_ROOM_BACKDROPS; ii++)
+  {
+    image = room->ur_Backdrops[ii];
+
+    if (NULL == image)
+      break;
+
+    layer = &Layers[ii];
+    layer->ly_Image = image;
+    layer->ly_Factor = room->ur_Room->rm_Parallax[ii];
+
+    /* Archives without scroll factors */
+    if (0 == layer->ly_Factor)
+    {
+      layer->ly_Factor = 256;
+    }
+
+    layer->ly_Offset = LayerPosition(layer, LayerCamX);
+    layer->ly_Dirty = 3;
+
+    LayerCount++;
+  }
+
+  /* A blitted layer without a mask would cover every layer behind it */
+  for (ii = 0; ii + 1 < LayerCount; ii++)
+  {
+    if (NULL == Layers[ii].ly_Image->im_Mask)
+    {
+      LOG_WARN("Room layer %ld has no mask, the %ld layers behind it are not drawn", (ULONG) ii, (ULONG) (LayerCount - ii - 1));
+      LayerCount = ii + 1;
+      break;
+    }
+  }
+}
+
+EXPORT VOID LayersShutdown()
+{
+  FillMem((UBYTE*) &Layers[0], sizeof(Layers), 0);
+  LayerCount = 0;
+}
+
+EXPORT VOID LayerSetImage(UWORD index, struct IMAGE* image)
+{
+  struct LAYER* layer;
+
+  if (index >= LayerCount)
+  {
+    return;
+  }
+
+  layer = &Layers[index];
+  layer->ly_Image = image;
+  layer->ly_Dirty = 3;
+}
+
+EXPORT VOID LayersScroll(WORD camX)
+{
+  struct LAYER* layer;
+  WORD offset;
+  UWORD ii;
+  BOOL moved;
+
+  /* Only the window is composited with more than one layer, so moving it exposes new columns */
+  moved = camX != LayerCamX && LayerCount > 1;
+
+  LayerCamX = camX;
+
+  for (ii = 0; ii < LayerCount; ii++)
+  {
+    layer = &Layers[ii];
+    offset = LayerPosition(layer, camX);
+
+    if (moved || offset != layer->ly_Offset)
+    {
+      layer->ly_Offset = offset;
+      layer->ly_Dirty = 3;
+    }
+  }
+}
+
+EXPORT VOID LayersInvalidate()
+{
+  UWORD ii;
+
+  for (ii = 0; ii < LayerCount; ii++)
+  {
+    Layers[ii].ly_Dirty = 3;
+  }
+}
+
+EXPORT BOOL LayersAreDirty()
+{
+  UWORD ii;
+
+  for (ii = 0; ii < LayerCount; ii++)
+  {
+    if (Layers[ii].ly_Dirty != 0)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*
+  Composites any layer that changed into the write buffer.
+
+  A single layer is blitted whole. With more layers only the visible window is composited,
+  back to front with the front layers masked, as the back layers move within the room bitmap.
+
+  Returns TRUE if the write buffer was drawn over.
+*/
+EXPORT BOOL LayersDraw(UWORD vp)
+{
+  struct LAYER* layer;
+  UWORD bit, ii, viewW, viewH;
+  BOOL  dirty;
+
+  bit = 1 << GfxGetWriteBuffer(vp);
+  dirty = FALSE;
+
+  for (ii = 0; ii < LayerCount; ii++)
+  {
+    layer = &Layers[ii];
+
+    if ((layer->ly_Dirty & bit) != 0)
+    {
+      dirty = TRUE;
+      layer->ly_Dirty &= ~bit;
+    }
+  }
+
+  if (dirty == FALSE)
+  {
+    return FALSE;
+  }
+
+  if (LayerCount == 1)
+  {
+    layer = &Layers[0];
+    DrawLayerWindow(vp, layer, layer->ly_Offset, layer->ly_Image->im_Width, FALSE);
+    return TRUE;
+  }
+
+  GfxGetViewSize(vp, &viewW, &viewH);
+
+  for (ii = LayerCount; ii > 0; ii--)
+  {
+    layer = &Layers[ii - 1];
+    DrawLayerWindow(vp, layer, LayerCamX, viewW, ii != LayerCount);
+  }
+
+  return TRUE;
+}
@@ -0,0 +1,205 @@
+/**
+    $Id: Log.c, 1.0 2026/10/19 13:10:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/String.h>
+#include <Parrot/Log.h>
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+
+#include <dos/dos.h>
+#include <dos/dostags.h>
+
+/*
+    LogF formats straight into the next free slot of a ring and returns, it never waits on
+    I/O. A low priority process drains the ring to a DOS file, so the sink is chosen by the
+    Parrot/Log environment variable:
+
+      SER:                        Serial
+      CON:0/0/640/100/Parrot Log  A console window
+      RAM:Parrot.log              A file
+
+    When Parrot/Log is not set there is no drain process and LogF returns at once.
+
+    Only the game task writes LogWrite and only the drain process writes LogRead, so no
+    locking is needed. When the ring is full the message is dropped and counted.
+*/
+
+STATIC struct LOG_ENTRY LogEntries[MAX_LOG_ENTRIES];
+STATIC volatile UWORD LogWrite, LogRead;
+STATIC ULONG LogDropped;
+
+STATIC BPTR LogFile = 0;
+STATIC struct Process* LogProcess = NULL;
+STATIC struct Task* LogParent = NULL;
+
+STATIC CONST CHAR LogLevelNames[] = "EWIT";
+
+STATIC VOID LogDrainEntries()
+{
+  struct LOG_ENTRY* entry;
+  CHAR prefix[2];
+  UWORD read;
+
+  read = LogRead;
+
+  while (read != LogWrite)
+  {
+    entry = &LogEntries[read];
+
+    prefix[0] = LogLevelNames[entry->le_Level];
+    prefix[1] = ' ';
+
+    FWrite(LogFile, prefix, 2, 1);
+    FWrite(LogFile, entry->le_Text, entry->le_Length, 1);
+    FPutC(LogFile, '\n');
+
+    read = (read + 1) & (MAX_LOG_ENTRIES - 1);
+    LogRead = read;
+  }
+
+  Flush(LogFile);
+}
+
+STATIC VOID LogDrain()
+{
+  ULONG signals;
+
+  while (TRUE)
+  {
+    signals = Wait(SIGBREAKF_CTRL_C | SIGBREAKF_CTRL_E);
+
+    LogDrainEntries();
+
+    if ((signals & SIGBREAKF_CTRL_C) != 0)
+      break;
+  }
+
+  /* Still in Forbid when this process ends, so the parent cannot unload the code first */
+  Forbid();
+  Signal(LogParent, SIGBREAKF_CTRL_F);
+}
+
+EXPORT VOID LogInitialise()
+{
+  CHAR path[256];
+
+  LogWrite = 0;
+  LogRead = 0;
+  LogDropped = 0;
+
+  if (GetVar("Parrot/Log", path, sizeof(path), 0) <= 0)
+  {
+    return;
+  }
+
+  LogFile = Open(path, MODE_NEWFILE);
+
+  if (LogFile == 0)
+  {
+    return;
+  }
+
+  LogParent = FindTask(NULL);
+  SetSignal(0, SIGBREAKF_CTRL_F);
+
+  LogProcess = CreateNewProcTags(
+    NP_Entry, (ULONG) LogDrain,
+    NP_Name, (ULONG) "Parrot Log",
+    NP_Priority, -1,
+    TAG_DONE
+  );
+
+  if (LogProcess == NULL)
+  {
+    Close(LogFile);
+    LogFile = 0;
+  }
+}
+
+EXPORT VOID LogShutdown()
+{
+  if (LogProcess != NULL)
+  {
+    Signal((struct Task*) LogProcess, SIGBREAKF_CTRL_C);
+    Wait(SIGBREAKF_CTRL_F);
+    LogProcess = NULL;
+  }
+
+  if (LogFile != 0)
+  {
+    Close(LogFile);
+    LogFile = 0;
+  }
+}
+
+EXPORT VOID LogF(UWORD level, CONST_STRPTR pFmt, ...)
+{
+  struct LOG_ENTRY* entry;
+  UWORD write, next;
+  ULONG length;
+  va_list args;
+
+  if (LogProcess == NULL)
+  {
+    return;
+  }
+
+  write = LogWrite;
+  next = (write + 1) & (MAX_LOG_ENTRIES - 1);
+
+  if (next == LogRead)
+  {
+    LogDropped++;
+    return;
+  }
+
+  entry = &LogEntries[write];
+  entry->le_Level = level;
+
+  va_start(args, pFmt);
+  length = StrFormatV(entry->le_Text, MAX_LOG_LENGTH, pFmt, args);
+  va_end(args);
+
+  /* Long messages are kept truncated */
+  if (length >= MAX_LOG_LENGTH)
+  {
+    length = MAX_LOG_LENGTH - 1;
+  }
+
+  entry->le_Length = length;
+
+  LogWrite = next;
+
+  Signal((struct Task*) LogProcess, SIGBREAKF_CTRL_E);
+}
+
+EXPORT ULONG LogGetDropped()
+{
+  return LogDropped;
+}
@@ -28,6 +28,8 @@
 #include <Parrot/Parrot.h>
 #include <Parrot/Requester.h>
 #include <Parrot/Graphics.h>
+#include <Parrot/Log.h>
+#include <Parrot/Clock.h>
 
 #include <proto/exec.h>
 #include <proto/dos.h>
@@ -83,6 +85,8 @@ INT main()
     goto CLEAN_EXIT;
   }
 
+  LogInitialise();
+
   IntuitionBase = (struct IntuitionBase*) OpenLibrary("intuition.library", 33L);
 
   if (NULL == IntuitionBase)
@@ -137,6 +141,7 @@ INT main()
 
   if (NULL != DOSBase)
   {
+    LogShutdown();
     CloseLibrary((struct Library*) DOSBase);
     DOSBase = NULL;
   }
@@ -151,6 +156,8 @@ extern VOID exit();
 
 VOID ExitNow()
 {
+  /* The VBlank server and timer.device must go before the code and memory they use */
+  ClockShutdown();
 
   ExitArenaNow();
   GfxHide();
@@ -185,6 +192,7 @@ VOID ExitNow()
 
   if (NULL != DOSBase)
   {
+    LogShutdown();
     CloseLibrary((struct Library*) DOSBase);
     DOSBase = NULL;
   }
@@ -0,0 +1,174 @@
+/**
+    $Id: Planar.c, 1.0 2026/10/19 15:05:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Planar.h>
+
+/*
+    Chunky to planar conversion in one pass over the pixels.
+
+    Each pixel looks up its low and high nibble in PlanarSpread, which puts bit N of the
+    nibble into the lowest bit of byte N. Shifting the sum left once per pixel builds the
+    bytes of up to four planes side by side, eight pixels at a time, so every plane comes
+    out of the same read of the source.
+
+    The planes are written one after another, each row being bytesPerRow bytes which must
+    be even and hold the width. Pixels past the width are taken as colour 0, any padding
+    after the last word of a row is left as it is.
+*/
+
+STATIC CONST ULONG PlanarSpread[16] =
+{
+  0x00000000, 0x00000001, 0x00000100, 0x00000101,
+  0x00010000, 0x00010001, 0x00010100, 0x00010101,
+  0x01000000, 0x01000001, 0x01000100, 0x01000101,
+  0x01010000, 0x01010001, 0x01010100, 0x01010101
+};
+
+#define PLANAR_BYTE(L, N) ((UWORD) (((L) >> ((N) << 3)) & 0xFF))
+
+STATIC VOID PlanarSpreadPixels(CONST UBYTE* pSrc, UWORD count, ULONG* pLo, ULONG* pHi)
+{
+  ULONG lo, hi;
+  UBYTE col;
+
+  lo = 0;
+  hi = 0;
+
+  while (count--)
+  {
+    col = *pSrc++;
+    lo = (lo << 1) | PlanarSpread[col & 0xF];
+    hi = (hi << 1) | PlanarSpread[col >> 4];
+  }
+
+  *pLo = lo;
+  *pHi = hi;
+}
+
+EXPORT VOID PlanarFromChunky(CONST UBYTE* pSrc, UWORD* pDst, UWORD width, UWORD height, UWORD depth, UWORD bytesPerRow)
+{
+  ULONG  planeWords, pos;
+  ULONG  lo0, hi0, lo1, hi1;
+  UWORD  x, y, bp, left, right, rowWords;
+  UWORD* plane;
+
+  rowWords = bytesPerRow >> 1;
+  planeWords = (ULONG) rowWords * height;
+
+  if (depth > 8)
+  {
+    depth = 8;
+  }
+
+  for (y = 0; y < height; y++)
+  {
+    pos = (ULONG) y * rowWords;
+
+    for (x = 0; x < width; x += 16)
+    {
+      left = width - x;
+
+      if (left >= 16)
+      {
+        PlanarSpreadPixels(pSrc + x, 8, &lo0, &hi0);
+        PlanarSpreadPixels(pSrc + x + 8, 8, &lo1, &hi1);
+      }
+      else
+      {
+        /* A partial word, the missing pixels are shifted in as 0 */
+        right = left > 8 ? left - 8 : 0;
+        left = left > 8 ? 8 : left;
+
+        PlanarSpreadPixels(pSrc + x, left, &lo0, &hi0);
+        PlanarSpreadPixels(pSrc + x + 8, right, &lo1, &hi1);
+
+        lo0 <<= 8 - left;
+        hi0 <<= 8 - left;
+        lo1 <<= 8 - right;
+        hi1 <<= 8 - right;
+      }
+
+      plane = pDst + pos;
+
+      for (bp = 0; bp < depth; bp++)
+      {
+        if (bp < 4)
+        {
+          *plane = (PLANAR_BYTE(lo0, bp) << 8) | PLANAR_BYTE(lo1, bp);
+        }
+        else
+        {
+          *plane = (PLANAR_BYTE(hi0, bp - 4) << 8) | PLANAR_BYTE(hi1, bp - 4);
+        }
+
+        plane += planeWords;
+      }
+
+      pos++;
+    }
+
+    pSrc += width;
+  }
+}
+
+EXPORT VOID PlanarMaskFromChunky(CONST UBYTE* pSrc, UWORD* pDst, UWORD width, UWORD height, UBYTE transparent, UWORD bytesPerRow)
+{
+  UWORD x, y, i, word, count;
+  UWORD* row;
+
+  for (y = 0; y < height; y++)
+  {
+    row = pDst;
+
+    for (x = 0; x < width; x += 16)
+    {
+      word = 0;
+      count = width - x;
+
+      if (count > 16)
+      {
+        count = 16;
+      }
+
+      for (i = 0; i < count; i++)
+      {
+        word <<= 1;
+
+        if (pSrc[x + i] != transparent)
+        {
+          word |= 1;
+        }
+      }
+
+      *row++ = word << (16 - count);
+    }
+
+    pDst += bytesPerRow >> 1;
+    pSrc += width;
+  }
+}
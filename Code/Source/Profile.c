@@ -0,0 +1,145 @@
+/**
+    $Id: Profile.c, 1.0 2026/10/19 12:40:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Graphics.h>
+#include <Parrot/Clock.h>
+#include <Parrot/Profile.h>
+
+#if defined(PARROT_PROFILE)
+
+/*
+    Zones are timed with the EClock and summed over a frame. At the end of each frame the
+    time of each zone goes into a running average and a histogram of eight buckets, each
+    double the time of the last, starting below 128 microseconds.
+
+    The overlay has one row per zone, in PROFILE_* order. On the left is a bar of the average
+    time at 50 microseconds a pixel, and on the right the histogram buckets shaded by count.
+*/
+
+#define PROFILE_ROW_HEIGHT  4
+#define PROFILE_BAR_WIDTH   160
+#define PROFILE_BAR_SHIFT   6     /* About 50 microseconds a pixel */
+
+STATIC ULONG ProfileStart[MAX_PROFILE_ZONES];
+STATIC ULONG ProfileTicks[MAX_PROFILE_ZONES];
+STATIC ULONG ProfileAvg[MAX_PROFILE_ZONES];
+STATIC UBYTE ProfileHistogram[MAX_PROFILE_ZONES][PROFILE_BUCKETS];
+
+EXPORT VOID ProfileBegin(UWORD zone)
+{
+  ProfileStart[zone] = ClockNow();
+}
+
+EXPORT VOID ProfileEnd(UWORD zone)
+{
+  ProfileTicks[zone] += ClockNow() - ProfileStart[zone];
+}
+
+EXPORT VOID ProfileFrame()
+{
+  ULONG micros, t;
+  UWORD ii, jj, bucket;
+  UBYTE* histogram;
+
+  for (ii = 0; ii < MAX_PROFILE_ZONES; ii++)
+  {
+    micros = ClockMicros(0, ProfileTicks[ii]);
+    ProfileTicks[ii] = 0;
+
+    ProfileAvg[ii] = ProfileAvg[ii] - (ProfileAvg[ii] >> 4) + (micros >> 4);
+
+    bucket = 0;
+    t = micros >> 7;
+
+    while (t != 0 && bucket < PROFILE_BUCKETS - 1)
+    {
+      t >>= 1;
+      bucket++;
+    }
+
+    histogram = &ProfileHistogram[ii][0];
+
+    if (histogram[bucket] == 255)
+    {
+      for (jj = 0; jj < PROFILE_BUCKETS; jj++)
+      {
+        histogram[jj] >>= 1;
+      }
+    }
+
+    histogram[bucket]++;
+  }
+}
+
+EXPORT VOID ProfileDraw(UWORD vp, WORD y)
+{
+  UWORD ii, jj, max, pen;
+  WORD  width, x;
+  UBYTE* histogram;
+
+  GfxSetAPen(vp, 0);
+  GfxRectFill(vp, 0, y, 319, y + MAX_PROFILE_ZONES * PROFILE_ROW_HEIGHT - 1);
+
+  for (ii = 0; ii < MAX_PROFILE_ZONES; ii++, y += PROFILE_ROW_HEIGHT)
+  {
+    width = ProfileAvg[ii] >> PROFILE_BAR_SHIFT;
+
+    if (width > PROFILE_BAR_WIDTH)
+    {
+      width = PROFILE_BAR_WIDTH;
+    }
+
+    if (width > 0)
+    {
+      GfxSetAPen(vp, 1 + (ii % 3));
+      GfxRectFill(vp, 0, y, width - 1, y + PROFILE_ROW_HEIGHT - 2);
+    }
+
+    histogram = &ProfileHistogram[ii][0];
+    max = 1;
+
+    for (jj = 0; jj < PROFILE_BUCKETS; jj++)
+    {
+      if (histogram[jj] > max)
+        max = histogram[jj];
+    }
+
+    for (jj = 0, x = PROFILE_BAR_WIDTH + 8; jj < PROFILE_BUCKETS; jj++, x += 18)
+    {
+      if (histogram[jj] == 0)
+        continue;
+
+      pen = 1 + ((histogram[jj] * 2) / max);
+
+      GfxSetAPen(vp, pen);
+      GfxRectFill(vp, x, y, x + 15, y + PROFILE_ROW_HEIGHT - 2);
+    }
+  }
+}
+
+#endif
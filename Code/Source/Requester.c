@@ -26,6 +26,8 @@
 */
 
 #include <Parrot/Parrot.h>
+#include <Parrot/String.h>
+#include <Parrot/Log.h>
 
 #include <proto/exec.h>
 #include <proto/dos.h>
@@ -67,76 +69,35 @@ LONG Requester(CONST_STRPTR pOptions, CONST_STRPTR pText)
   return EasyRequest(RequesterWindow, &EasyRequesterStruct, NULL);
 }
 
-#if defined(IS_M68K)
-STATIC CONST ULONG PutChar = 0x16c04e75;
-STATIC CONST ULONG CountChar = 0x52934E75;
-#endif
-
 LONG RequesterF(CONST_STRPTR pOptions, CONST_STRPTR pFmt, ...)
 {
-#if defined(IS_M68K)
-  LONG size;;
-  STRPTR* arg;
+  va_list args;
+  ULONG   length;
 
-  size = 0;
-  arg = (STRPTR*)(&pFmt + 1);
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & CountChar, (STRPTR )&size);
+  va_start(args, pFmt);
+  length = StrFormatV(RequesterText, sizeof(RequesterText), pFmt, args);
+  va_end(args);
 
-  if (size >= sizeof(RequesterText) || (0 == size))
+  if (0 == length)
   {
     return 0;
   }
 
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & PutChar, (STRPTR) &RequesterText[0]);
-
   return Requester(pOptions, RequesterText);
-#else
-  return 0; /* Unimplemented */
-#endif
-}
-
-VOID TraceF(CONST_STRPTR pFmt, ...)
-{
-#if defined(IS_M68K)
-  LONG size;;
-  STRPTR* arg;
-
-  size = 0;
-  arg = (STRPTR*)(&pFmt + 1);
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & CountChar, (STRPTR)&size);
-
-  if (size >= sizeof(RequesterText) || (0 == size))
-  {
-    return;
-  }
-
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & PutChar, (STRPTR)&RequesterText[0]);
-
-  EasyRequesterStruct.es_GadgetFormat = "OK";
-  EasyRequesterStruct.es_Title = "Parrot Trace";
-  EasyRequesterStruct.es_TextFormat = &RequesterText[0];
-
-  EasyRequest(NULL, &EasyRequesterStruct, NULL);
-
-  EasyRequesterStruct.es_Title = "Parrot";
-#else
-  return; /* Unimplemented */
-#endif
 }
 
 VOID ExitNow();
 
 VOID ErrorF(CONST_STRPTR pFmt, ...)
 {
-#if defined(IS_M68K)
-  LONG size;;
-  STRPTR* arg;
+  va_list args;
+  ULONG   length;
 
-  size = 0;
-  arg = (STRPTR*)(&pFmt + 1);
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & CountChar, (STRPTR)&size);
+  va_start(args, pFmt);
+  length = StrFormatV(RequesterText, sizeof(RequesterText), pFmt, args);
+  va_end(args);
 
-  if (size >= sizeof(RequesterText) || (0 == size))
+  if (0 == length)
   {
     EasyRequesterStruct.es_Title = "Parrot Error";
     EasyRequesterStruct.es_TextFormat = "No Message Given.";
@@ -146,7 +107,7 @@ VOID ErrorF(CONST_STRPTR pFmt, ...)
     ExitNow();
   }
 
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & PutChar, (STRPTR)&RequesterText[0]);
+  LOG_ERROR("%s", &RequesterText[0]);
 
   EasyRequesterStruct.es_GadgetFormat = "OK";
   EasyRequesterStruct.es_Title = "Parrot Error";
@@ -155,9 +116,6 @@ VOID ErrorF(CONST_STRPTR pFmt, ...)
   EasyRequest(NULL, &EasyRequesterStruct, NULL);
 
   ExitNow();
-#else
-  return; /* Unimplemented */
-#endif
 }
 
 VOID SetRequesterWindow(APTR window)
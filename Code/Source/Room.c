@@ -33,6 +33,13 @@
 #include <Parrot/Graphics.h>
 #include <Parrot/Input.h>
 #include <Parrot/Game.h>
+#include <Parrot/Layer.h>
+#include <Parrot/Camera.h>
+#include <Parrot/HitGrid.h>
+#include <Parrot/Clock.h>
+#include <Parrot/Profile.h>
+#include <Parrot/Log.h>
+#include <Parrot/Room.h>
 
 #include <proto/dos.h>
 #include <proto/graphics.h>
@@ -41,12 +48,15 @@ EXTERN WORD CursorX;
 EXTERN WORD CursorY;
 
 STATIC VOID PlayRoomDebug(struct UNPACKED_ROOM* room);
+STATIC VOID DrawRoom(struct UNPACKED_ROOM* room);
 
 EXPORT VOID UnpackRoom(struct UNPACKED_ROOM* room, ULONG unpack)
 {
   UBYTE ii;
   UWORD id;
 
+  LOG_INFO("Unpack room %ld %lx", (ULONG) room->ur_Id, unpack);
+
   if ((unpack & UNPACK_ROOM_ASSET) != 0 && (room->ur_Unpacked & UNPACK_ROOM_ASSET) == 0)
   {
     room->ur_Room = LoadAssetT(struct ROOM, ArenaChapter, room->ur_Id, CT_ROOM, room->ur_Id, CHUNK_FLAG_ARCH_ANY);
@@ -62,10 +72,17 @@ EXPORT VOID UnpackRoom(struct UNPACKED_ROOM* room, ULONG unpack)
 
       if (0 != id && NULL == room->ur_Backdrops[ii])
       {
-        room->ur_Backdrops[ii] = LoadAsset(ArenaRoom, room->ur_Id, CT_IMAGE, id, CHUNK_FLAG_ARCH_ANY);
+        room->ur_Backdrops[ii] = LoadAsset(ArenaRoom, room->ur_Id, CT_IMAGE, id, GfxGetArch());
       }
     }
 
+    id = room->ur_Room->rm_ZPlane;
+
+    if (0 != id && NULL == room->ur_ZPlane)
+    {
+      room->ur_ZPlane = LoadAsset(ArenaRoom, room->ur_Id, CT_IMAGE, id, GfxGetArch());
+    }
+
     room->ur_Unpacked |= UNPACK_ROOM_BACKDROPS;
   }
 
@@ -83,6 +100,13 @@ EXPORT VOID UnpackRoom(struct UNPACKED_ROOM* room, ULONG unpack)
         room->ur_Exits[ii] = LoadAsset(ArenaRoom, room->ur_Id, CT_ENTITY, id, CHUNK_FLAG_ARCH_ANY);
       }
 
+      id = room->ur_Exits[ii]->ex_Image;
+
+      if (0 != id && NULL == room->ur_ExitImages[ii])
+      {
+        room->ur_ExitImages[ii] = LoadAsset(ArenaRoom, room->ur_Id, CT_IMAGE, id, GfxGetArch());
+      }
+
     }
 
     for (ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
@@ -96,8 +120,17 @@ EXPORT VOID UnpackRoom(struct UNPACKED_ROOM* room, ULONG unpack)
       {
         room->ur_Entities[ii] = LoadAsset(ArenaRoom, room->ur_Id, CT_ENTITY, id, CHUNK_FLAG_ARCH_ANY);
       }
+
+      id = ((struct ENTITY*) room->ur_Entities[ii])->en_Image;
+
+      if (0 != id && NULL == room->ur_EntityImages[ii])
+      {
+        room->ur_EntityImages[ii] = LoadAsset(ArenaRoom, room->ur_Id, CT_IMAGE, id, GfxGetArch());
+      }
     }
 
+    HitGridBuild(room);
+
     room->ur_Unpacked |= UNPACK_ROOM_ENTITIES;
   }
 }
@@ -108,6 +141,8 @@ EXPORT VOID PackRoom(struct UNPACKED_ROOM* room, ULONG pack)
   UWORD backdrop;
   UWORD id;
 
+  LOG_INFO("Pack room %ld %lx", (ULONG) room->ur_Id, pack);
+
   if ((pack & UNPACK_ROOM_ENTITIES) != 0 && (room->ur_Unpacked & UNPACK_ROOM_ENTITIES) != 0)
   {
     for (ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
@@ -117,6 +152,12 @@ EXPORT VOID PackRoom(struct UNPACKED_ROOM* room, ULONG pack)
       if (0 == id)
         break;
 
+      if (NULL != room->ur_EntityImages[ii])
+      {
+        UnloadAsset(ArenaRoom, room->ur_EntityImages[ii]);
+        room->ur_EntityImages[ii] = NULL;
+      }
+
       if (NULL != room->ur_Entities[ii])
       {
         UnloadAsset(ArenaRoom, room->ur_Entities[ii]);
@@ -131,6 +172,12 @@ EXPORT VOID PackRoom(struct UNPACKED_ROOM* room, ULONG pack)
       if (0 == id)
         break;
 
+      if (NULL != room->ur_ExitImages[ii])
+      {
+        UnloadAsset(ArenaRoom, room->ur_ExitImages[ii]);
+        room->ur_ExitImages[ii] = NULL;
+      }
+
       if (NULL != room->ur_Exits[ii])
       {
         UnloadAsset(ArenaRoom, room->ur_Exits[ii]);
@@ -138,7 +185,10 @@ EXPORT VOID PackRoom(struct UNPACKED_ROOM* room, ULONG pack)
       }
     }
 
-    room->ur_Unpacked &= ~MAX_ROOM_ENTITIES;
+    /* Freed with the rest of ArenaRoom */
+    room->ur_HitGrid = NULL;
+
+    room->ur_Unpacked &= ~UNPACK_ROOM_ENTITIES;
   }
 
   if ((pack & UNPACK_ROOM_BACKDROPS) != 0 && (room->ur_Unpacked & UNPACK_ROOM_BACKDROPS) != 0)
@@ -154,6 +204,12 @@ EXPORT VOID PackRoom(struct UNPACKED_ROOM* room, ULONG pack)
       }
     }
 
+    if (NULL != room->ur_ZPlane)
+    {
+      UnloadAsset(ArenaRoom, room->ur_ZPlane);
+      room->ur_ZPlane = NULL;
+    }
+
     room->ur_Unpacked &= ~UNPACK_ROOM_BACKDROPS;
   }
 
@@ -192,9 +248,79 @@ STATIC struct EXIT* FindExit(struct UNPACKED_ROOM* room, UWORD id)
   return exit;
 }
 
-STATIC BOOL PointInside(struct RECT* rect, WORD x, WORD y)
+/*
+  Shows or hides the open state patch of an entity or exit. Only the patch rectangle is
+  redrawn, once per display buffer.
+*/
+VOID SetEntityOpen(struct UNPACKED_ROOM* room, struct ENTITY* entity, BOOL open)
+{
+  UWORD ii;
+
+  if (open)
+  {
+    entity->en_Flags |= ETF_IS_OPEN;
+  }
+  else
+  {
+    entity->en_Flags &= ~ETF_IS_OPEN;
+  }
+
+  for (ii = 0; ii < MAX_ROOM_EXITS; ii++)
+  {
+    if ((struct ENTITY*) room->ur_Exits[ii] == entity && NULL != room->ur_ExitImages[ii])
+    {
+      room->ur_ExitPatches[ii] = 3;
+      return;
+    }
+  }
+
+  for (ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
+  {
+    if ((struct ENTITY*) room->ur_Entities[ii] == entity && NULL != room->ur_EntityImages[ii])
+    {
+      room->ur_EntityPatches[ii] = 3;
+      return;
+    }
+  }
+}
+
+/*
+  Blits the patch when open, or the backdrop underneath it when closed.
+*/
+STATIC VOID DrawPatch(struct UNPACKED_ROOM* room, struct ENTITY* entity, struct IMAGE* image)
 {
-  return x >= rect->rt_Left && x <= rect->rt_Right && y >= rect->rt_Top && y <= rect->rt_Bottom;
+  WORD x, y;
+
+  x = entity->en_ImagePos.pt_Left;
+  y = entity->en_ImagePos.pt_Top;
+
+  if ((entity->en_Flags & ETF_IS_OPEN) != 0)
+  {
+    GfxBlitBitmap(0, image, x, y, 0, 0, image->im_Width, image->im_Height);
+  }
+  else
+  {
+    GfxBlitBitmap(0, room->ur_Backdrops[0], x, y, x, y, image->im_Width, image->im_Height);
+  }
+}
+
+STATIC BOOL PatchesAreDirty(struct UNPACKED_ROOM* room)
+{
+  UWORD ii;
+
+  for (ii = 0; ii < MAX_ROOM_EXITS; ii++)
+  {
+    if (room->ur_ExitPatches[ii] != 0)
+      return TRUE;
+  }
+
+  for (ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
+  {
+    if (room->ur_EntityPatches[ii] != 0)
+      return TRUE;
+  }
+
+  return FALSE;
 }
 
 VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInfo)
@@ -203,11 +329,11 @@ VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInf
   struct INPUTEVENT evt;
   UWORD screenW, screenH;
   BOOL exitRoom;
-  UWORD mostLeftEdge;
   UWORD ii;
   WORD rmMouseX, rmMouseY;
   BOOL updateCaption;
   BOOL hasCaption;
+  ULONG frames;
 
   exitRoom = FALSE;
 
@@ -226,26 +352,19 @@ VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInf
   room.ur_Id = entrance->en_Room;
 
   UnpackRoom(&room, UNPACK_ROOM_ASSET | UNPACK_ROOM_BACKDROPS | UNPACK_ROOM_ENTITIES);
+  LayersInitialise(&room);
 
-  mostLeftEdge = room.ur_Room->rm_Width - gameInfo->gi_Width;
-
-  if (mostLeftEdge > 1)
-  {
-    mostLeftEdge -= 1;
-  }
+  CameraInitialise(&room.ur_Camera, room.ur_Room->rm_Width, gameInfo->gi_Width, 0);
 
   if (entrance->en_Exit != 0 && room.ur_Room->rm_Width > gameInfo->gi_Width)
   {
     struct EXIT* exit;
 
     exit = FindExit(&room, entrance->en_Exit);
-    room.ur_CamX = exit->ex_HitBox.rt_Left;
-    room.ur_CamY = 0;
+    CameraSnap(&room.ur_Camera, exit->ex_HitBox.rt_Left);
 
-    if (room.ur_CamX > mostLeftEdge)
-      room.ur_CamX = mostLeftEdge;
-    else if (room.ur_CamX < 0)
-      room.ur_CamX = 0;
+    room.ur_CamX = room.ur_Camera.cm_X;
+    room.ur_CamY = 0;
 
     room.ur_UpdateFlags |= UFLG_SCROLL;
   }
@@ -260,6 +379,11 @@ VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInf
 
   while (exitRoom == FALSE && InEvtForceQuit == FALSE)
   {
+    /* Sleeps until there is input or the next frame */
+    frames = ClockBeginFrame(InputIsReplayingFast() == FALSE);
+
+    PROFILE_BEGIN(PROFILE_INPUT);
+
     while (PopEvent(&evt))
     {
       switch (evt.ie_Type)
@@ -294,55 +418,19 @@ VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInf
         case IET_CURSOR:
         {
           struct ENTITY* entity;
-          BOOL didFind;
 
-          didFind = FALSE;
-          rmMouseX = room.ur_CamX + CursorX;
-          rmMouseY = room.ur_CamY + CursorY;
+          rmMouseX = room.ur_CamX + evt.ie_CursX;
+          rmMouseY = room.ur_CamY + evt.ie_CursY;
 
-          for (UWORD ii = 0; ii < MAX_ROOM_EXITS; ii++)
-          {
-            entity = (struct ENTITY*) room.ur_Exits[ii];
-          
-            if (NULL != entity && PointInside(&entity->en_HitBox, rmMouseX, rmMouseY))
-            {
-              didFind = TRUE;
-
-              if (room.ur_HoverEntity != entity)
-              {
-                room.ur_HoverEntity = entity;
-                room.ur_UpdateFlags |= UFLG_CAPTION;
-                break;
-              }
-            }
-          }
-
-          if (didFind == FALSE)
-          {
-            for (UWORD ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
-            {
-              entity = (struct ENTITY*) room.ur_Entities[ii];
-
-              if (NULL != entity && PointInside(&entity->en_HitBox, rmMouseX, rmMouseY))
-              {
-                didFind = TRUE;
-
-                if (room.ur_HoverEntity != entity)
-                {
-                  room.ur_HoverEntity = entity;
-                  room.ur_UpdateFlags |= UFLG_CAPTION;
-                  break;
-                }
-              }
-            }
-          }
+          PROFILE_BEGIN(PROFILE_HITTEST);
+          entity = HitGridFind(&room, rmMouseX, rmMouseY);
+          PROFILE_END(PROFILE_HITTEST);
 
-          if (didFind == FALSE && room.ur_HoverEntity != NULL)
+          if (room.ur_HoverEntity != entity)
           {
-            room.ur_HoverEntity = NULL;
+            room.ur_HoverEntity = entity;
             room.ur_UpdateFlags |= UFLG_CAPTION;
           }
-
         }
         break;
         case IET_SELECT:
@@ -366,20 +454,36 @@ VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInf
       }
     }
 
+    PROFILE_END(PROFILE_INPUT);
+
+    /* Only input was handled, anything it changed is drawn on the next frame */
+    if (frames == 0)
+    {
+      continue;
+    }
+
     if (IsMenuDown())
     {
-      room.ur_CamX = CursorX << 2;
+      CameraSetTarget(&room.ur_Camera, CursorX << 2);
+    }
 
-      if (room.ur_CamX < 0)
-      {
-        room.ur_CamX = 0;
-      }
-      else if (room.ur_CamX > mostLeftEdge)
+    /* Logic runs once per frame passed, so it keeps the same pace when a frame is missed */
+    while (frames-- > 0)
+    {
+      if (CameraUpdate(&room.ur_Camera))
       {
-        room.ur_CamX = mostLeftEdge;
+        room.ur_CamX = room.ur_Camera.cm_X;
+        room.ur_UpdateFlags |= UFLG_SCROLL;
       }
 
-      room.ur_UpdateFlags |= UFLG_SCROLL;
+      InputNextFrame();
+    }
+
+    if (ClockShouldRender() == FALSE)
+    {
+      ClockEndFrame(FALSE);
+      PROFILE_FRAME();
+      continue;
     }
 
     if ((room.ur_UpdateFlags & (UFLG_SCENE | UFLG_DEBUG)) != 0)
@@ -389,74 +493,147 @@ VOID PlayRoom(UWORD screen, struct ENTRANCE* entrance, struct GAME_INFO* gameInf
 
     if ((room.ur_UpdateFlags & UFLG_CAPTION) != 0)
     {
+      PROFILE_BEGIN(PROFILE_CAPTION);
       PlayCaption(&room);
+      PROFILE_END(PROFILE_CAPTION);
     }
 
     if ((room.ur_UpdateFlags & UFLG_SCROLL) != 0)
     {
       GfxSetScrollOffset(0, room.ur_CamX, 0);
+      LayersScroll(room.ur_CamX);
       room.ur_UpdateFlags &= ~UFLG_SCROLL;
     }
 
 
     if ((room.ur_UpdateFlags & UFLG_SCENE) != 0)
     {
-      struct EXIT* exit;
-      struct ENTITY* entity;
-
       room.ur_UpdateFlags &= ~UFLG_SCENE;
+      room.ur_SceneBuffers = 3;
+      LayersInvalidate();
+    }
 
-      GfxBlitBitmap(0, room.ur_Backdrops[0], 0, 0, 0, 0, room.ur_Backdrops[0]->im_Width, room.ur_Backdrops[0]->im_Height);
-      {
-        if ((room.ur_UpdateFlags & UFLG_DEBUG) != 0)
-        {
-          for (UWORD ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
-          {
+    if (room.ur_SceneBuffers != 0 || PatchesAreDirty(&room) || LayersAreDirty())
+    {
+      DrawRoom(&room);
+    }
 
-            exit = room.ur_Exits[ii];
+    ClockEndFrame(TRUE);
+    PROFILE_FRAME();
+  }
 
-            if (NULL == exit)
-              break;
+  if (InEvtForceQuit == TRUE)
+  {
+    entrance->en_Room = 0;
+  }
 
-            GfxDrawHitBox(0, &exit->ex_HitBox, &exit->ex_Name[0], StrLen(exit->ex_Name));
+  /* Unload */
+  LayersShutdown();
+  PackRoom(&room, UNPACK_ROOM_ASSET | UNPACK_ROOM_BACKDROPS | UNPACK_ROOM_ENTITIES);
+}
 
-          }
+/*
+  Draws the room into the write buffer of the room viewport and submits it.
 
-          for (UWORD ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
-          {
+  Both display buffers need the backdrop after a scene change, the remaining one
+  is drawn on the next frame. Otherwise only the entity patches that changed
+  state and any backdrop layer that moved are drawn.
+*/
+STATIC VOID DrawRoom(struct UNPACKED_ROOM* room)
+{
+  struct EXIT* exit;
+  struct ENTITY* entity;
+  UWORD buffer, ii;
+  BOOL scene;
 
-            entity = room.ur_Entities[ii];
+  PROFILE_BEGIN(PROFILE_BLIT);
 
-            if (NULL == entity)
-              break;
+  buffer = GfxGetWriteBuffer(0);
+  scene = (room->ur_SceneBuffers & (1 << buffer)) != 0;
+  room->ur_SceneBuffers &= ~(1 << buffer);
 
-            GfxDrawHitBox(0, &entity->en_HitBox, &entity->en_Name[0], StrLen(entity->en_Name));
+  if (LayersDraw(0) || scene)
+  {
+    LOG_TRACE("Redraw scene in buffer %ld", (ULONG) buffer);
+    scene = TRUE;
+  }
 
-          }
-        }
-      }
+  for (ii = 0; ii < MAX_ROOM_EXITS; ii++)
+  {
+    entity = (struct ENTITY*) room->ur_Exits[ii];
 
-      GfxSubmit(0);
+    if (NULL == entity)
+      break;
+
+    if (NULL != room->ur_ExitImages[ii] && (scene || (room->ur_ExitPatches[ii] & (1 << buffer)) != 0))
+    {
+      room->ur_ExitPatches[ii] &= ~(1 << buffer);
+
+      if (!scene || (entity->en_Flags & ETF_IS_OPEN) != 0)
+      {
+        DrawPatch(room, entity, room->ur_ExitImages[ii]);
+      }
     }
+  }
+
+  for (ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
+  {
+    entity = (struct ENTITY*) room->ur_Entities[ii];
+
+    if (NULL == entity)
+      break;
+
+    if (NULL != room->ur_EntityImages[ii] && (scene || (room->ur_EntityPatches[ii] & (1 << buffer)) != 0))
+    {
+      room->ur_EntityPatches[ii] &= ~(1 << buffer);
 
+      if (!scene || (entity->en_Flags & ETF_IS_OPEN) != 0)
+      {
+        DrawPatch(room, entity, room->ur_EntityImages[ii]);
+      }
+    }
   }
 
-  if (InEvtForceQuit == TRUE)
+  if (scene)
   {
-    entrance->en_Room = 0;
+    if ((room->ur_UpdateFlags & UFLG_DEBUG) != 0)
+    {
+      for (ii = 0; ii < MAX_ROOM_EXITS; ii++)
+      {
+        exit = room->ur_Exits[ii];
+
+        if (NULL == exit)
+          break;
+
+        GfxDrawHitBox(0, &exit->ex_HitBox, &exit->ex_Name[0], StrLen(exit->ex_Name));
+      }
+
+      for (ii = 0; ii < MAX_ROOM_ENTITIES; ii++)
+      {
+        entity = (struct ENTITY*) room->ur_Entities[ii];
+
+        if (NULL == entity)
+          break;
+
+        GfxDrawHitBox(0, &entity->en_HitBox, &entity->en_Name[0], StrLen(entity->en_Name));
+      }
+    }
   }
 
-  /* Unload */
-  PackRoom(&room, UNPACK_ROOM_ASSET | UNPACK_ROOM_BACKDROPS | UNPACK_ROOM_ENTITIES);
-}
+  PROFILE_END(PROFILE_BLIT);
 
+  PROFILE_BEGIN(PROFILE_SUBMIT);
+  GfxSubmit(0);
+  PROFILE_END(PROFILE_SUBMIT);
+}
 
 STATIC VOID PlayRoomDebug(struct UNPACKED_ROOM* room)
 {
   UWORD numExits, numEntities;
   UWORD ii;
-  UWORD strLen;
-  CHAR  debugText[40];
+  ULONG strLen;
+  CHAR  debugText[64];
+  struct CLOCK_STATS stats;
   
   for (ii = 0, numExits = 0; ii < MAX_ROOM_EXITS; ii++)
   {
@@ -471,7 +648,24 @@ STATIC VOID PlayRoomDebug(struct UNPACKED_ROOM* room)
   }
 
 
-  strLen = StrFormat(debugText, sizeof(debugText), "Rm %ld Ex %ld En %ld", (ULONG)room->ur_Id, (ULONG)numExits, (ULONG) numEntities )-1;
-  GfxMove(1, 0, 50);
-  GfxText(1, debugText, strLen);
+  strLen = StrFormat(debugText, sizeof(debugText), "Rm %ld Ex %ld En %ld Ov %ld", (ULONG)room->ur_Id, (ULONG)numExits, (ULONG) numEntities, InputOverflows);
+
+  if (strLen > 0)
+  {
+    GfxMove(1, 0, 50);
+    GfxText(1, debugText, (WORD) (strLen - 1));
+  }
+
+  ClockGetStats(&stats);
+
+  /* Four ten digit counters still fit, StrFormat returns 0 if they did not */
+  strLen = StrFormat(debugText, sizeof(debugText), "Ft %ld Av %ld Mx %ld Sk %ld", stats.cs_FrameTime, stats.cs_FrameTimeAvg, stats.cs_FrameTimeMax, stats.cs_Skipped);
+
+  if (strLen > 0)
+  {
+    GfxMove(1, 0, 60);
+    GfxText(1, debugText, (WORD) (strLen - 1));
+  }
+
+  PROFILE_DRAW(1, 14);
 }
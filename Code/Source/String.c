@@ -26,8 +26,11 @@
 */
 
 #include <Parrot/Parrot.h>
+#include <Parrot/String.h>
 
+#if defined(IS_M68K)
 #include <proto/exec.h>
+#endif
 
 ULONG StrLength(CONST_STRPTR pStr)
 {
@@ -49,53 +52,205 @@ ULONG StrLength(CONST_STRPTR pStr)
   return length;
 }
 
-#if defined(IS_M68K)
-STATIC CONST ULONG PutChar = 0x16c04e75;
-STATIC CONST ULONG CountChar = 0x52934E75;
-#endif
+/*
+    StrFormatV writes the formatted text in one pass. Text beyond the capacity is counted
+    but not stored, so the return is always the full length without the terminator, and
+    the output was truncated when that is not less than the capacity. A NULL buffer only
+    counts.
+
+    Supports %ld %lu %lx %lX %d %u %x %X %s %c and %%, with '-', '0' and a width. The l
+    is accepted for the existing RawDoFmt style strings, every integer is read as a LONG.
+*/
+
+STATIC CONST CHAR HexDigitsLower[] = "0123456789abcdef";
+STATIC CONST CHAR HexDigitsUpper[] = "0123456789ABCDEF";
+
+ULONG StrFormatV(CHAR* pBuffer, LONG pBufferCapacity, CONST CHAR* pFmt, va_list pArgs)
+{
+  CHAR  digits[12];
+  CHAR* digit;
+  CONST CHAR* str;
+  CONST CHAR* hex;
+  CHAR  ch, pad;
+  ULONG length, value, limit;
+  ULONG width, strLen, total, base;
+  BOOL  left, negative;
+
+  length = 0;
+  limit = (pBuffer != NULL && pBufferCapacity > 0) ? (ULONG)(pBufferCapacity - 1) : 0;
+
+#define STR_PUT(C) do { if (length < limit) pBuffer[length] = (C); length++; } while(0)
+
+  while ((ch = *pFmt++) != '\0')
+  {
+    if (ch != '%')
+    {
+      STR_PUT(ch);
+      continue;
+    }
+
+    left = FALSE;
+    pad = ' ';
+    width = 0;
+
+    if (*pFmt == '-')
+    {
+      left = TRUE;
+      pFmt++;
+    }
+
+    if (*pFmt == '0')
+    {
+      pad = '0';
+      pFmt++;
+    }
+
+    while (*pFmt >= '0' && *pFmt <= '9')
+    {
+      width = width * 10 + (*pFmt++ - '0');
+    }
+
+    if (*pFmt == 'l')
+    {
+      pFmt++;
+    }
+
+    ch = *pFmt++;
+    negative = FALSE;
+    str = NULL;
+    strLen = 0;
+
+    switch (ch)
+    {
+      case 'd':
+      case 'u':
+      case 'x':
+      case 'X':
+      {
+        value = va_arg(pArgs, ULONG);
+        base = (ch == 'x' || ch == 'X') ? 16 : 10;
+        hex = (ch == 'X') ? HexDigitsUpper : HexDigitsLower;
+
+        if (ch == 'd' && (LONG) value < 0)
+        {
+          negative = TRUE;
+          value = 0U - value;
+        }
+
+        digit = &digits[sizeof(digits)];
+
+        do
+        {
+          *--digit = hex[value % base];
+          strLen++;
+          value /= base;
+        } while (value != 0);
+
+        str = digit;
+      }
+      break;
+      case 's':
+      {
+        str = va_arg(pArgs, CONST CHAR*);
+
+        if (str == NULL)
+        {
+          str = "";
+        }
+
+        strLen = StrLen(str);
+      }
+      break;
+      case 'c':
+      {
+        digits[0] = (CHAR) va_arg(pArgs, LONG);
+        str = &digits[0];
+        strLen = 1;
+      }
+      break;
+      case '\0':
+      {
+        pFmt--;
+      }
+      continue;
+      default:
+      {
+        STR_PUT(ch);
+      }
+      continue;
+    }
+
+    total = strLen + (negative ? 1 : 0);
+
+    if (negative && pad == '0')
+    {
+      STR_PUT('-');
+    }
+
+    if (left == FALSE)
+    {
+      for (; width > total; width--)
+      {
+        STR_PUT(pad);
+      }
+    }
+
+    if (negative && pad != '0')
+    {
+      STR_PUT('-');
+    }
+
+    for (; strLen > 0; strLen--)
+    {
+      STR_PUT(*str++);
+    }
+
+    if (left)
+    {
+      for (; width > total; width--)
+      {
+        STR_PUT(' ');
+      }
+    }
+  }
+
+#undef STR_PUT
+
+  if (pBuffer != NULL && pBufferCapacity > 0)
+  {
+    pBuffer[length < limit ? length : limit] = '\0';
+  }
+
+  return length;
+}
 
 ULONG StrLengthFormat(CHAR* pFmt, ...)
 {
-#if defined(IS_M68K)
-  LONG size;;
-  STRPTR* arg;
+  va_list args;
+  ULONG   length;
 
-  size = 0;
-  arg = (STRPTR*)(&pFmt + 1);
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) &CountChar, (STRPTR)&size);
+  va_start(args, pFmt);
+  length = StrFormatV(NULL, 0, pFmt, args);
+  va_end(args);
 
-  return size;
-#else
-  return 0; /* Unimplemented */
-#endif
+  return length + 1;
 }
 
 ULONG StrFormat(CHAR* pBuffer, LONG pBufferCapacity, CHAR* pFmt, ...)
 {
-#if defined(IS_M68K)
-  LONG size;
-  STRPTR* arg;
-  
-  if (0 == pBufferCapacity)
-  {
-    return 0;
-  }
-  
-  size = 0;
-  arg = (STRPTR*)(&pFmt + 1);
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) &CountChar, (STRPTR)&size);
+  va_list args;
+  ULONG   length;
 
-  if (size >= pBufferCapacity || (0 == size))
+  va_start(args, pFmt);
+  length = StrFormatV(pBuffer, pBufferCapacity, pFmt, args);
+  va_end(args);
+
+  if (pBufferCapacity <= 0 || length >= (ULONG) pBufferCapacity)
   {
     return 0;
   }
 
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) &PutChar, pBuffer);
-
-  return size;
-#else
-  return 0; /* Unimplemented */
-#endif
+  return length + 1;
 }
 
 ULONG StrLen(CONST CHAR* pSrc)
@@ -202,10 +357,108 @@ CLEAN_EXIT:
   return rc;
 }
 
+/*
+    FillMem and XorMem move longwords eight at a time once the destination is aligned,
+    leaving only the ends to be done a byte at a time. Copies use exec's CopyMem, which
+    the C kernels did not beat, see StringTest.
+*/
+
+#if defined(IS_HOST)
+#define ADDRESS_ALIGN(P) ((ULONG) ((uintptr_t) (P) & 3))
+#else
+#define ADDRESS_ALIGN(P) ((ULONG) (P) & 3)
+#endif
+
 VOID FillMem(UBYTE* pDst, ULONG length, UBYTE value)
 {
+  ULONG  fill, blocks;
+  ULONG* dst;
+
+  while (length != 0 && ADDRESS_ALIGN(pDst) != 0)
+  {
+    *pDst++ = value;
+    length--;
+  }
+
+  if (length >= 4)
+  {
+    fill = value;
+    fill |= fill << 8;
+    fill |= fill << 16;
+
+    dst = (ULONG*) pDst;
+
+    for (blocks = length >> 5; blocks != 0; blocks--)
+    {
+      dst[0] = fill;
+      dst[1] = fill;
+      dst[2] = fill;
+      dst[3] = fill;
+      dst[4] = fill;
+      dst[5] = fill;
+      dst[6] = fill;
+      dst[7] = fill;
+      dst += 8;
+    }
+
+    for (blocks = (length & 31) >> 2; blocks != 0; blocks--)
+    {
+      *dst++ = fill;
+    }
+
+    pDst = (UBYTE*) dst;
+    length &= 3;
+  }
+
   while (length--)
   {
     *pDst++ = value;
   }
 }
+
+VOID XorMem(UBYTE* pDst, ULONG length, UBYTE value)
+{
+  ULONG  mask, blocks;
+  ULONG* dst;
+
+  while (length != 0 && ADDRESS_ALIGN(pDst) != 0)
+  {
+    *pDst++ ^= value;
+    length--;
+  }
+
+  if (length >= 4)
+  {
+    mask = value;
+    mask |= mask << 8;
+    mask |= mask << 16;
+
+    dst = (ULONG*) pDst;
+
+    for (blocks = length >> 5; blocks != 0; blocks--)
+    {
+      dst[0] ^= mask;
+      dst[1] ^= mask;
+      dst[2] ^= mask;
+      dst[3] ^= mask;
+      dst[4] ^= mask;
+      dst[5] ^= mask;
+      dst[6] ^= mask;
+      dst[7] ^= mask;
+      dst += 8;
+    }
+
+    for (blocks = (length & 31) >> 2; blocks != 0; blocks--)
+    {
+      *dst++ ^= mask;
+    }
+
+    pDst = (UBYTE*) dst;
+    length &= 3;
+  }
+
+  while (length--)
+  {
+    *pDst++ ^= value;
+  }
+}
@@ -51,11 +51,6 @@
 
 extern struct GfxBase* GfxBase;
 
-#define ARCH_UNKNOWN 0
-#define ARCH_ECS     1
-#define ARCH_AGA     2
-#define ARCH_RTG     3
-
 struct CURSOR_IMAGE
 {
   WORD  OffsetX, OffsetY;
@@ -91,6 +86,7 @@ UWORD                ScreenWidth;
 UWORD                ScreenHeight;
 UWORD                NumViewPorts;
 UWORD                IsShown;
+UWORD                Arch;
 
 STATIC ULONG DefaultPalette[] =
 {
@@ -113,9 +109,20 @@ EXPORT VOID GfxInitialise()
   ScreenHeight = 0;
   IntuitionView = NULL;
 
+  Arch = (GfxBase->ChipRevBits0 & GFXF_AA_ALICE) != 0 ? CHUNK_FLAG_ARCH_AGA : CHUNK_FLAG_ARCH_ECS;
+
   InitView(&View);
 }
 
+/*
+  The CHUNK_FLAG_ARCH_* flag of the chipset found by GfxInitialise, assets are loaded with
+  it so only the variant made for this chipset is read.
+*/
+EXPORT UWORD GfxGetArch()
+{
+  return Arch;
+}
+
 EXPORT VOID ViewExitNow()
 {
   GfxHide();
@@ -434,6 +441,33 @@ EXPORT VOID GfxBlitBitmap(UWORD id, struct IMAGE* image, WORD dx, WORD dy, WORD
   BltBitMapRastPort((struct BitMap*) image, sx, sy, rp, dx, dy + offset, sw, sh, 0xC0);
 }
 
+/*
+  Cookie-cut blit. Only pixels set in the mask are copied, the mask must have the same layout
+  as a single bitplane of the image.
+*/
+EXPORT VOID GfxBlitBitmapMasked(UWORD id, struct IMAGE* image, UBYTE* mask, WORD dx, WORD dy, WORD sx, WORD sy, WORD sw, WORD sh)
+{
+  struct RastPort* rp;
+  WORD offset;
+
+  offset = ViewPorts[id].v_WriteOffset;
+
+  rp = &ViewPorts[id].v_RastPort;
+
+  BltMaskBitMapRastPort((struct BitMap*) image, sx, sy, rp, dx, dy + offset, sw, sh, (ABC | ABNC | ANBC), (PLANEPTR) mask);
+}
+
+EXPORT UWORD GfxGetWriteBuffer(UWORD id)
+{
+  return ViewPorts[id].v_WriteOffset == 0 ? 0 : 1;
+}
+
+EXPORT VOID GfxGetViewSize(UWORD id, UWORD* width, UWORD* height)
+{
+  *width = ViewPorts[id].v_Width;
+  *height = ViewPorts[id].v_Height;
+}
+
 
 EXPORT VOID GfxDrawHitBox(UWORD id, struct RECT* rect, STRPTR name, UWORD nameLength)
 {
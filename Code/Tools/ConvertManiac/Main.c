@@ -25,23 +25,37 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#include <exec/types.h>
+#include <Asset.h>
+#include <Parrot/Io.h>
+#include <Parrot/Planar.h>
+#include <Parrot/Hash.h>
+
+#include <stdarg.h>
+
+#include "Serialise.h"
+
+/*
+    On the host the rooms are converted by a pool of threads. Everything a room export works
+    on is kept per thread, and the table rows of each room are merged in export order once
+    every room is done, so the output is the same for any number of threads.
+*/
+#if defined(PARROT_HOST)
+#include <pthread.h>
+#include <unistd.h>
+#define WORKER_LOCAL _Thread_local
+#else
+#define WORKER_LOCAL
+#endif
+
+#if defined(IS_M68K)
 #include <proto/exec.h>
 #include <proto/dos.h>
 #include <proto/intuition.h>
-#include <proto/iffparse.h>
-#include <libraries/iffparse.h>
-
-
-#include <Asset.h>
 
 struct ExecBase* SysBase;
 struct DosLibrary* DOSBase;
-struct Library* IFFParseBase;
 struct IntuitionBase* IntuitionBase;
-
-
-
+#endif
 
 #define RC_OKAY RETURN_OK
 #define RC_FAIL RETURN_FAIL
@@ -56,19 +70,150 @@ struct IntuitionBase* IntuitionBase;
 
 #define NO_ROOMS 54
 
-STATIC struct IFFHandle* DstIff;
-STATIC UBYTE* SrcFileData;
-STATIC UBYTE* SrcFilePos;
-STATIC UBYTE* SrcFileEnd;
-STATIC ULONG  NextRoomId;
+#define ZPLANE_IMAGE_ID(ROOM) (0x100 + (ROOM))
+#define OBJECT_IMAGE_ID(ENTITY) (0x400 + (ENTITY))
+
+STATIC WORKER_LOCAL struct IFF_WRITER DstIff;
+STATIC CHAR   InputPath[256];
+STATIC CHAR   OutputPath[256];
+STATIC WORKER_LOCAL struct LFL_FILE* SrcLfl;
+STATIC WORKER_LOCAL UBYTE* SrcFileData;
+STATIC WORKER_LOCAL UBYTE* SrcFilePos;
+STATIC WORKER_LOCAL UBYTE* SrcFileEnd;
+STATIC WORKER_LOCAL BOOL   SrcOverrun;
+STATIC UWORD  NumRooms;
 STATIC ULONG  NextBackdropId;
-STATIC UWORD  CurrentArchiveId;
+STATIC WORKER_LOCAL UWORD  CurrentArchiveId;
 STATIC UWORD  NextEntityId;
+STATIC WORKER_LOCAL UBYTE* BackdropChunky;
+STATIC WORKER_LOCAL UWORD  BackdropWidth;
+STATIC WORKER_LOCAL UWORD  BackdropHeight;
+
+/*
+    A Maniac Mansion room file, with the parts of its header that the lookup and export
+    passes both need. lf_Data is only loaded whilst the file is being read, so the memory
+    used does not grow with the number of rooms.
+*/
+struct LFL_FILE
+{
+  UWORD                lf_MmId;
+  UBYTE*               lf_Data;
+  ULONG                lf_Size;
+  UWORD                lf_Width;
+  UWORD                lf_Height;
+  UWORD                lf_ImageOffset;
+  UWORD                lf_ZPlaneOffset;
+  UWORD                lf_NumObjects;
+  UWORD                lf_ObjImg[256];
+  UWORD                lf_ObjDat[256];
+  UWORD                lf_ObjId[256];
+  BOOL                 lf_Present;
+  ULONG                lf_Hash;
+  ULONG                lf_Check;        /* Second hash from another seed */
+};
+
+/*
+    A room being converted. Table rows are held here until the rooms are merged.
+    Each exit and entity may have an image, plus the backdrop, z-plane and room. The
+    backdrop may be written once for each chipset.
+*/
+#define MAX_JOB_ROWS (2 * (MAX_ROOM_EXITS + MAX_ROOM_ENTITIES) + 4)
+
+struct JOB_ROW
+{
+  struct OBJECT_TABLE* jr_Table;
+  UWORD                jr_Id;
+  UWORD                jr_Archive;
+  UWORD                jr_Flags;
+  ULONG                jr_Size;
+  ULONG                jr_Hash;         /* Of the chunk payload, 0 if it is never shared */
+  UWORD                jr_ChunkArchive; /* Where the data is, after duplicates are merged */
+  UWORD                jr_ChunkId;
+  BOOL                 jr_Stored;       /* The chunk is in this room's archive */
+};
+
+struct ROOM_JOB
+{
+  struct LFL_FILE*     rj_Lfl;
+  ULONG                rj_Key;
+  ULONG                rj_Check;
+  BOOL                 rj_Unchanged;
+  BOOL                 rj_Converted;
+  BOOL                 rj_Strip;
+  ULONG                rj_RoomArena;
+  ULONG                rj_RoomChip;
+  ULONG                rj_ChapterArena;
+  UWORD                rj_NumRows;
+  struct JOB_ROW       rj_Rows[MAX_JOB_ROWS];
+};
+
+/*
+    Every shareable chunk kept so far, by class, size and payload hash. Later chunks with
+    the same payload point their table rows at the first one instead of being stored again.
+    The hash only finds the candidates, the bytes of both chunks are compared first.
+*/
+#define MAX_PAYLOADS ((NO_ROOMS + 1) * MAX_JOB_ROWS)
+
+struct PAYLOAD
+{
+  ULONG                pl_ClassType;
+  ULONG                pl_Size;
+  ULONG                pl_Hash;
+  UWORD                pl_Archive;
+  UWORD                pl_ChunkId;
+  UWORD                pl_Flags;
+};
+
+STATIC struct PAYLOAD Payloads[MAX_PAYLOADS];
+STATIC ULONG  NumPayloads;
+
+/*
+    Room archives read back to compare payloads. Slot 0 holds the archive of the chunk
+    being looked up and slot 1 that of the payload it is compared against.
+*/
+#define PAYLOAD_SLOT_CHUNK 0
+#define PAYLOAD_SLOT_KEPT  1
+
+struct ARCHIVE_CACHE
+{
+  UBYTE*               ac_Data;
+  ULONG                ac_Size;
+  UWORD                ac_Archive;
+};
+
+STATIC struct ARCHIVE_CACHE ArchiveCache[2];
+
+STATIC WORKER_LOCAL struct ROOM_JOB* CurrentJob;
+STATIC UWORD  NumWorkers;
+STATIC UWORD  RoomsConverted;
+STATIC UWORD  RoomsUnchanged;
+
+/*
+    Bytes per row of an image, rows are whole words. The player leaves AGA in FMODE 0, so
+    playfields fetch words there as well and one layout is shown on any chipset.
+*/
+#define IMAGE_ROW_ECS(W) ((((W) + 15) >> 4) << 1)
+
+/*
+    The memory each room needs when played is added up as its chunks are exported. Arena
+    bytes are what LoadAsset allocates for a chunk, chip bytes are the image planes and masks
+    that UnpackBitmap allocates. The largest of each over all rooms goes into GAME_INFO.
+*/
+#define ASSET_ARENA_SIZE(SIZE) ((sizeof(struct ASSET) + SIZEOF_CHUNK_HEADER + (SIZE) + 3) & ~3)
+
+STATIC WORKER_LOCAL ULONG  RoomArenaBytes;
+STATIC WORKER_LOCAL ULONG  RoomChipBytes;
+STATIC WORKER_LOCAL ULONG  ChapterArenaBytes;
+STATIC ULONG  MaxRoomArena;
+STATIC ULONG  MaxRoomChip;
+STATIC ULONG  MaxChapterArena;
 
 ULONG StrFormat(CHAR* pBuffer, LONG pBufferCapacity, CHAR* pFmt, ...);
 ULONG StrCopy(CHAR* pDst, ULONG pDstCapacity, CONST CHAR* pSrc);
-
-STATIC VOID MemClear(APTR pMem, ULONG size);
+ULONG StrLen(CONST CHAR* pSrc);
+ULONG StrFormatV(CHAR* pBuffer, LONG pBufferCapacity, CONST CHAR* pFmt, va_list pArgs);
+VOID FillMem(UBYTE* pDst, ULONG length, UBYTE value);
+VOID XorMem(UBYTE* pDst, ULONG length, UBYTE value);
 
 STATIC VOID OpenParrotIff(UWORD id);
 STATIC VOID CloseParrotIff();
@@ -78,22 +223,34 @@ STATIC VOID ExportPalette(UWORD id);
 STATIC VOID ExportCursorPalette(UWORD id);
 STATIC VOID ExportRoom(UWORD id, UWORD backdrop);
 STATIC VOID ExportBackdrop(UWORD id, UWORD palette);
+STATIC VOID ExportImage(UWORD id, UWORD palette, UBYTE* chunky, UWORD w, UWORD h, UWORD options);
+STATIC VOID ExportImageLayout(UWORD id, UWORD palette, UBYTE* chunky, UWORD w, UWORD h, UWORD options, UWORD bytesPerRow, UWORD arch);
+STATIC VOID ExportZPlane(UWORD id, UWORD w, UWORD h, ULONG zOffset);
+STATIC UWORD ExportObjectImage(UWORD id, ULONG imgOffset, struct RECT* hitBox, struct POINT* pos);
 STATIC VOID ReadImageData(UBYTE* tgt, UWORD w, UWORD h);
-STATIC VOID ConvertImageDataToPlanar(UBYTE* src, UWORD* dst, UWORD w, UWORD h);
-STATIC UWORD ReadUWORDBE();
+STATIC VOID ReadZPlaneData(UBYTE* tgt, UWORD w, UWORD h, UWORD bytesPerRow);
 STATIC UWORD ReadUWORDLE();
 STATIC UBYTE ReadUBYTE();
 STATIC VOID AddToTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD flags, ULONG size);
+STATIC VOID AddSharedToTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD flags, ULONG size, ULONG chunkStart);
+STATIC struct PAYLOAD* FindPayload(ULONG classType, ULONG size, ULONG hash, UWORD flags, CONST UBYTE* data, ULONG length);
+STATIC VOID AddPayload(ULONG classType, ULONG size, ULONG hash, UWORD archive, UWORD chunkId, UWORD flags);
+STATIC CONST UBYTE* ChunkPayload(UWORD slot, UWORD archive, ULONG classType, UWORD id, UWORD flags, ULONG* out_length);
+STATIC VOID FreeArchiveCache();
+STATIC VOID InsertIntoTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD chunkId, UWORD flags, ULONG size);
 STATIC VOID InitTable(struct OBJECT_TABLE* table, ULONG type);
+STATIC struct OBJECT_TABLE* NextTable(struct OBJECT_TABLE* table);
 STATIC VOID ExportTable(struct OBJECT_TABLE* table, UWORD id, UWORD tableRefSlot);
 STATIC VOID ResolveLookupTables();
 
 STATIC LONG DebugF(CONST_STRPTR pFmt, ...);
+STATIC VOID Convert();
 
-STATIC ULONG OpenLFL(CHAR* basePath, UWORD id);
-STATIC VOID CloseLFL();
+STATIC VOID LoadLFLs();
+STATIC BOOL OpenLFL(struct LFL_FILE* lfl);
+STATIC VOID CloseLFL(struct LFL_FILE* lfl);
+STATIC VOID SelectLFL(struct LFL_FILE* lfl);
 STATIC BOOL SeekFile(ULONG pos);
-STATIC BOOL JumpFile(LONG extraPos);
 
 STATIC struct OBJECT_TABLE_REF TableRefs[16];
 STATIC struct OBJECT_TABLE RoomTable;
@@ -101,16 +258,67 @@ STATIC struct OBJECT_TABLE ImageTable;
 STATIC struct OBJECT_TABLE PaletteTable;
 STATIC struct OBJECT_TABLE EntityTable;
 
+/*
+    A table that is full goes on in one of these, linked by its ot_NextRef, and is
+    written to the game archive under its own chunk id.
+*/
+#define MAX_EXTRA_TABLES 64
+#define EXTRA_TABLE_ID(N) (16 + (N))
+
+STATIC struct OBJECT_TABLE ExtraTables[MAX_EXTRA_TABLES];
+STATIC UWORD NumExtraTables;
+
+STATIC VOID Convert()
+{
+  NextBackdropId = 1;
+  NextEntityId = 1;
+  MaxRoomArena = 0;
+  MaxRoomChip = 0;
+  MaxChapterArena = 0;
+  NumExtraTables = 0;
+
+  FillMem((UBYTE*)&RoomTable, sizeof(RoomTable), 0);
+  FillMem((UBYTE*)&ImageTable, sizeof(ImageTable), 0);
+  FillMem((UBYTE*)&PaletteTable, sizeof(PaletteTable), 0);
+
+  InitTable(&RoomTable, CT_ROOM);
+  InitTable(&ImageTable, CT_IMAGE);
+  InitTable(&PaletteTable, CT_PALETTE);
+  InitTable(&EntityTable, CT_ENTITY);
+
+  LoadLFLs();
+
+  ResolveLookupTables();
+
+  ExportRooms();
+
+  CurrentArchiveId = 0;
+  OpenParrotIff(0);
+
+  ExportPalette(1);
+  ExportCursorPalette(2);
+  ExportTable(&PaletteTable, 1, 0);
+  ExportTable(&RoomTable, 2, 1);
+  ExportTable(&ImageTable, 3, 2);
+  ExportTable(&EntityTable, 4, 3);
+
+  ExportGame(1, &TableRefs[0], 1, 2, 1);
+
+  CloseParrotIff();
+  FreeArchiveCache();
+}
+
+#if defined(IS_M68K)
+
 INT main()
 {
   INT rc;
-  UWORD ii;
 
   struct Process* process;
   struct Message* wbMsg;
 
-  DstIff = NULL;
   rc = RETURN_OK;
+  wbMsg = NULL;
 
   SysBase = *(struct ExecBase**) 4L;
 
@@ -140,53 +348,15 @@ INT main()
     goto CLEAN_EXIT;
   }
 
-  IFFParseBase = (struct Library*) OpenLibrary("iffparse.library", 0);
-
-  if (NULL == IFFParseBase)
-  {
-    goto CLEAN_EXIT;
-  }
-  
-  NextBackdropId = 1;
-  NextEntityId = 1;
-
-  MemClear((APTR)&RoomTable, sizeof(RoomTable));
-  MemClear((APTR)&ImageTable, sizeof(ImageTable));
-  MemClear((APTR)&PaletteTable, sizeof(PaletteTable));
-
-  InitTable(&RoomTable, CT_ROOM);
-  InitTable(&ImageTable, CT_IMAGE);
-  InitTable(&PaletteTable, CT_PALETTE);
-  InitTable(&EntityTable, CT_ENTITY);
-
-  ResolveLookupTables();
-
-  ExportRooms();
-
-  CurrentArchiveId = 0;
-  OpenParrotIff(0);
-
-  ExportPalette(1);
-  ExportCursorPalette(2);
-  ExportTable(&PaletteTable, 1, 0);
-  ExportTable(&RoomTable, 2, 1);
-  ExportTable(&ImageTable, 3, 2);
-  ExportTable(&EntityTable, 4, 3);
-
-  ExportGame(1, &TableRefs[0], 1, 2, 1);
+  StrCopy(InputPath, sizeof(InputPath), "PROGDIR:");
+  StrCopy(OutputPath, sizeof(OutputPath), "PROGDIR:");
 
-  CloseParrotIff();
+  Convert();
 
-  DebugF("Converted.");
+  DebugF("Converted %ld rooms, %ld unchanged.", (ULONG) RoomsConverted, (ULONG) RoomsUnchanged);
 
 CLEAN_EXIT:
 
-  if (NULL != IFFParseBase)
-  {
-    CloseLibrary((struct Library*) IFFParseBase);
-    IFFParseBase = NULL;
-  }
-
   if (NULL != wbMsg)
   {
     Forbid();
@@ -205,13 +375,64 @@ CLEAN_EXIT:
     DOSBase = NULL;
   }
 
+  return rc;
+}
+
+#else
+
+/*
+    On the host the converter is a command line tool. Paths are used as given, so a
+    trailing separator is added when it is missing.
+*/
+STATIC VOID SetPath(CHAR* dst, ULONG capacity, CONST CHAR* src)
+{
+  ULONG len;
+
+  StrCopy(dst, capacity, src);
+  len = StrLen(dst);
+
+  if (len > 0 && len < capacity - 1 && dst[len - 1] != '/')
+  {
+    dst[len] = '/';
+    dst[len + 1] = 0;
+  }
+}
+
+INT main(INT argc, CHAR** argv)
+{
+  LONG cpus;
+
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  NumWorkers = cpus > 0 ? (UWORD) cpus : 1;
+
+  if (argc >= 3 && argv[1][0] == '-' && argv[1][1] == 'j' && argv[1][2] == 0)
+  {
+    NumWorkers = (UWORD) atoi(argv[2]);
+    argc -= 2;
+    argv += 2;
+  }
+
+  if (argc < 3 || 0 == NumWorkers)
+  {
+    fputs("Usage: ConvertManiac [-j threads] <input dir> <output dir>\n", stderr);
+    return RETURN_FAIL;
+  }
+
+  SetPath(InputPath, sizeof(InputPath), argv[1]);
+  SetPath(OutputPath, sizeof(OutputPath), argv[2]);
+
+  Convert();
+
+  DebugF("Converted %ld rooms, %ld unchanged.", (ULONG) RoomsConverted, (ULONG) RoomsUnchanged);
+
   return RETURN_OK;
 }
 
-STATIC CONST ULONG PutChar = 0x16c04e75;
-STATIC CONST ULONG CountChar = 0x52934E75;
-char RequesterText[1024];
+#endif
+
+WORKER_LOCAL char RequesterText[1024];
 
+#if defined(IS_M68K)
 struct EasyStruct EasyRequesterStruct =
 {
   sizeof(struct EasyStruct),
@@ -220,46 +441,48 @@ struct EasyStruct EasyRequesterStruct =
   &RequesterText[0],
   "Ok",
 };
+#endif
 
 STATIC LONG DebugF(CONST_STRPTR pFmt, ...)
 {
-  LONG size;;
-  STRPTR* arg;
+  va_list args;
+  ULONG   length;
 
-  size = 0;
-  arg = (STRPTR*)(&pFmt + 1);
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & CountChar, (STRPTR)&size);
+  va_start(args, pFmt);
+  length = StrFormatV(RequesterText, sizeof(RequesterText), pFmt, args);
+  va_end(args);
 
-  if (size >= sizeof(RequesterText) || (0 == size))
+  if (0 == length)
   {
     return 0;
   }
 
-  RawDoFmt((STRPTR)pFmt, arg, (void (*)(void)) & PutChar, (STRPTR)&RequesterText[0]);
-
-  EasyRequest(NULL, &EasyRequesterStruct, NULL);
-
+#if defined(IS_M68K)
+  return EasyRequest(NULL, &EasyRequesterStruct, NULL);
+#else
+  fputs(RequesterText, stderr);
+  fputs("\n", stderr);
+  return 1;
+#endif
 }
 
 
-STATIC UWORD ReadUWORDBE()
-{
-  UWORD r = 0;
-
-  r = SrcFilePos[0] << 8 | SrcFilePos[1];
-  r ^= 0xFFFF;  /* Copy Protection */
-
-  SrcFilePos += 2;
-
-  return r;
-}
-
+/*
+    The readers work on the de-obfuscated file. Reading past the end of the file gives zeros
+    and marks the file as overrun, which is reported once the room has been converted.
+*/
 STATIC UWORD ReadUWORDLE()
 {
   UWORD r = 0;
 
+  if (SrcFilePos + 2 > SrcFileEnd)
+  {
+    SrcOverrun = TRUE;
+    SrcFilePos = SrcFileEnd;
+    return 0;
+  }
+
   r = SrcFilePos[1] << 8 | SrcFilePos[0]; /* Little Endian to Big Endian */
-  r ^= 0xFFFF;  /* Copy Protection */
 
   SrcFilePos += 2;
 
@@ -270,8 +493,13 @@ STATIC UBYTE ReadUBYTE()
 {
   UBYTE r = 0;
 
+  if (SrcFilePos >= SrcFileEnd)
+  {
+    SrcOverrun = TRUE;
+    return 0;
+  }
+
   r = SrcFilePos[0];
-  r ^= 0xFF;  /* Copy Protection */
 
   SrcFilePos += 1;
 
@@ -280,47 +508,40 @@ STATIC UBYTE ReadUBYTE()
 
 STATIC VOID OpenParrotIff(UWORD id)
 {
-  CHAR filename[26];
+  CHAR filename[280];
 
   CurrentArchiveId = id;
 
-  StrFormat(filename, sizeof(filename), "PROGDIR:%ld.Parrot", (ULONG)id);
-  
-  DstIff = AllocIFF();
-  DstIff->iff_Stream = Open(filename, MODE_NEWFILE);
-
-  InitIFFasDOS(DstIff);
-  OpenIFF(DstIff, IFFF_WRITE);
-
-  PushChunk(DstIff, ID_SQWK, ID_FORM, IFFSIZE_UNKNOWN);
+  StrFormat(filename, sizeof(filename), "%s%ld.Parrot", OutputPath, (ULONG)id);
 
+  IffOpenWriter(&DstIff, filename, ID_SQWK);
 }
 
 STATIC VOID CloseParrotIff()
 {
-  if (NULL != DstIff)
+  if (FALSE == IffCloseWriter(&DstIff))
   {
-    PopChunk(DstIff); /* ID_FORM */
-
-    CloseIFF(DstIff);
-    Close(DstIff->iff_Stream);
-    FreeIFF(DstIff);
-    DstIff = NULL;
+    DebugF("Could not write %s", DstIff.iw_Path);
   }
 }
 
 #include "Tables.h"
 
+/*
+  Every colour is a 4 bit value repeated, which OCS and ECS show exactly, so the one palette
+  is used on any chipset.
+*/
 STATIC VOID ExportPalette(UWORD id)
 {
   struct CHUNK_HEADER hdr;
   struct PALETTE_TABLE pal;
   ULONG* pData;
+  ULONG  start;
 
-  MemClear((APTR)&pal, sizeof(pal));
+  FillMem((UBYTE*)&pal, sizeof(pal), 0);
   
   hdr.ch_Id = id;
-  hdr.ch_Flags = CHUNK_FLAG_ARCH_AGA | CHUNK_FLAG_ARCH_RTG;
+  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
 
   pData = (ULONG*)&pal.pt_Data[0];
 
@@ -412,12 +633,14 @@ STATIC VOID ExportPalette(UWORD id)
   pal.pt_Begin = 0;
   pal.pt_End = 15;
 
-  PushChunk(DstIff, ID_SQWK, CT_PALETTE, sizeof(pal) + sizeof(hdr));
-  WriteChunkBytes(DstIff, &hdr, sizeof(hdr));
-  WriteChunkBytes(DstIff, &pal, sizeof(pal));
-  PopChunk(DstIff);
+  start = DstIff.iw_Size;
 
-  AddToTable(&PaletteTable, id, CurrentArchiveId, hdr.ch_Flags, sizeof(struct PALETTE_TABLE));
+  IffPushChunk(&DstIff, CT_PALETTE);
+  WriteChunkHeader(&DstIff, &hdr);
+  WritePaletteTable(&DstIff, &pal);
+  IffPopChunk(&DstIff);
+
+  AddSharedToTable(&PaletteTable, id, CurrentArchiveId, hdr.ch_Flags, SIZEOF_PALETTE_TABLE, start);
 }
 
 STATIC VOID ExportCursorPalette(UWORD id)
@@ -425,11 +648,12 @@ STATIC VOID ExportCursorPalette(UWORD id)
   struct CHUNK_HEADER   hdr;
   struct PALETTE_TABLE  pal;
   ULONG* pData;
+  ULONG  start;
 
-  MemClear((APTR)&pal, sizeof(pal));
+  FillMem((UBYTE*)&pal, sizeof(pal), 0);
 
   hdr.ch_Id = id;
-  hdr.ch_Flags = CHUNK_FLAG_ARCH_AGA | CHUNK_FLAG_ARCH_RTG;
+  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
 
   pData = (ULONG*) &pal.pt_Data[0];
 
@@ -444,12 +668,14 @@ STATIC VOID ExportCursorPalette(UWORD id)
   pal.pt_Begin = 17;
   pal.pt_End = 18;
 
-  PushChunk(DstIff, ID_SQWK, CT_PALETTE, sizeof(hdr) + sizeof(pal));
-  WriteChunkBytes(DstIff, &hdr, sizeof(hdr));
-  WriteChunkBytes(DstIff, &pal, sizeof(pal));
-  PopChunk(DstIff);
+  start = DstIff.iw_Size;
 
-  AddToTable(&PaletteTable, id, CurrentArchiveId, hdr.ch_Flags, sizeof(struct PALETTE_TABLE));
+  IffPushChunk(&DstIff, CT_PALETTE);
+  WriteChunkHeader(&DstIff, &hdr);
+  WritePaletteTable(&DstIff, &pal);
+  IffPopChunk(&DstIff);
+
+  AddSharedToTable(&PaletteTable, id, CurrentArchiveId, hdr.ch_Flags, SIZEOF_PALETTE_TABLE, start);
 }
 
 STATIC VOID ExportGame(UWORD id, struct OBJECT_TABLE_REF* tables, UWORD startPalette, UWORD startCursorPalette, UWORD startRoom)
@@ -459,7 +685,7 @@ STATIC VOID ExportGame(UWORD id, struct OBJECT_TABLE_REF* tables, UWORD startPal
   UWORD  tableCount;
 
   tableCount = 0;
-  MemClear(&info, sizeof(info));
+  FillMem((UBYTE*)&info, sizeof(info), 0);
 
   hdr.ch_Id = id;
   hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
@@ -472,10 +698,14 @@ STATIC VOID ExportGame(UWORD id, struct OBJECT_TABLE_REF* tables, UWORD startPal
   info.gi_Width  = 320;
   info.gi_Height = 200;
   info.gi_Depth  = 4;
-  info.gi_RoomCount = NO_ROOMS;
+  info.gi_RoomCount = NumRooms;
   info.gi_StartPalette = startPalette;
   info.gi_StartCursorPalette = startCursorPalette;
   info.gi_StartRoom = startRoom;
+  info.gi_RoomArena = MaxRoomArena;
+  info.gi_RoomChip = MaxRoomChip;
+  info.gi_ChapterArena = MaxChapterArena;
+  info.gi_TableArena = NumExtraTables * ((SIZEOF_OBJECT_TABLE + 3) & ~3);
 
   while (tables->tr_ChunkHeaderId != 0 && tableCount < 16)
   {
@@ -486,168 +716,327 @@ STATIC VOID ExportGame(UWORD id, struct OBJECT_TABLE_REF* tables, UWORD startPal
     tables++;
   }
 
-  PushChunk(DstIff, ID_SQWK, CT_GAME_INFO, sizeof(struct CHUNK_HEADER) + sizeof(struct GAME_INFO));
-  WriteChunkBytes(DstIff, &hdr, sizeof(struct CHUNK_HEADER));
-  WriteChunkBytes(DstIff, &info, sizeof(struct GAME_INFO));
-  PopChunk(DstIff);
+  IffPushChunk(&DstIff, CT_GAME_INFO);
+  WriteChunkHeader(&DstIff, &hdr);
+  WriteGameInfo(&DstIff, &info);
+  IffPopChunk(&DstIff);
 
 }
 
 STATIC VOID ExportBackdrop(UWORD id, UWORD palette)
 {
-  struct CHUNK_HEADER hdr;
-  struct IMAGE backdrop;
-
-  ULONG  chunkySize, planarSize, p, imgOffset;
+  ULONG  imgOffset;
   UBYTE* chunky;
-  UWORD* planar;
-  UWORD  x, y, w, h;
-  UBYTE  r, col, len, ii;
-
-  MemClear(&backdrop, sizeof(struct IMAGE));
-
-  SeekFile(4);
-  w = ReadUWORDLE();
-  h = ReadUWORDLE();
-
-  SeekFile(10);
-  imgOffset = ReadUWORDLE();
-
-  x = 0;
-  y = 0;
-  chunkySize = w * h;
-  planarSize = chunkySize / 2;
+  UWORD  w, h;
 
-  chunky = AllocVec(chunkySize, MEMF_CLEAR);
-  planar = AllocVec(planarSize, MEMF_CLEAR);
+  w = SrcLfl->lf_Width;
+  h = SrcLfl->lf_Height;
+  imgOffset = SrcLfl->lf_ImageOffset;
 
-  hdr.ch_Id = id;
-  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY | CHUNK_FLAG_HAS_DATA;
+  chunky = AllocVec(w * h, MEMF_CLEAR);
 
-  backdrop.im_Width = w;
-  backdrop.im_Height = h;
-  backdrop.im_Depth = 4;
-  backdrop.im_Palette = palette;
-  backdrop.im_BytesPerRow = (w >> 3);
-  backdrop.im_PlaneSize = backdrop.im_BytesPerRow * h;
-  
-  PushChunk(DstIff, ID_SQWK, CT_IMAGE, IFFSIZE_UNKNOWN);
-  WriteChunkBytes(DstIff, &hdr, sizeof(struct CHUNK_HEADER));
-  WriteChunkBytes(DstIff, &backdrop, sizeof(struct IMAGE));
   SeekFile(imgOffset);
   ReadImageData(chunky, w, h);
-  ConvertImageDataToPlanar(chunky, planar, w, h);
-  WriteChunkBytes(DstIff, planar, planarSize);
-  PopChunk(DstIff);
-
 
-  FreeVec(chunky);
-  FreeVec(planar);
+  ExportImage(id, palette, chunky, w, h, 0);
 
+  /* Kept until the room objects have been diffed against it */
+  BackdropChunky = chunky;
+  BackdropWidth = w;
+  BackdropHeight = h;
 
-  AddToTable(&ImageTable, id, CurrentArchiveId, hdr.ch_Flags, sizeof(struct IMAGE) + planarSize);
+  ExportZPlane(ZPLANE_IMAGE_ID(id), w, h, SrcLfl->lf_ZPlaneOffset);
 }
 
-#if 0
+/*
+  Exports the image of an object as a patch over the backdrop.
 
-STATIC VOID ExportEntity(UWORD id)
+  Only the rectangle of pixels that differ from the backdrop is kept, widened to 16 pixel
+  boundaries of the room so the blit is word aligned. Pixels in the patch outside of the
+  object are taken from the backdrop, so the patch can be blitted without a mask.
+
+  Returns the image id, or 0 if the object has no image or it matches the backdrop.
+*/
+STATIC UWORD ExportObjectImage(UWORD id, ULONG imgOffset, struct RECT* hitBox, struct POINT* pos)
 {
-  struct CHUNK_HEADER hdr;
-  struct ENTITY ent;
+  UBYTE* chunky;
+  UBYTE* patch;
+  UWORD  w, h, x, y, pw, ph;
+  WORD   minX, minY, maxX, maxY, left, top, rx, ry;
 
-  MemClear(&ent, sizeof(struct ENTITY));
+  w = hitBox->rt_Right - hitBox->rt_Left;
+  h = hitBox->rt_Bottom - hitBox->rt_Top;
 
-  hdr.ch_Id = id;
-  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
+  if (0 == imgOffset || 0 == w || 0 == h || NULL == BackdropChunky)
+  {
+    return 0;
+  }
 
-  ent.ob_Type = ET_INFO;
+  chunky = AllocVec(w * h, MEMF_CLEAR);
 
-  JumpFile(7);
-  ent.ob_HitBox.rt_Left = ((UWORD) ReadUBYTE()) << 3;
-  ent.ob_HitBox.rt_Top = ((UWORD) (ReadUBYTE() & 0xF)) << 3;
-  ent.ob_HitBox.rt_Right =  ((UWORD)ReadUBYTE()) << 3;
-  ent.ob_HitBox.rt_Right += ent.ob_HitBox.rt_Left;
-  JumpFile(4);
-  ent.ob_HitBox.rt_Bottom =  ((UWORD)(ReadUBYTE() & 0xF8));
-  ent.ob_HitBox.rt_Bottom += ent.ob_HitBox.rt_Top;
+  SeekFile(imgOffset);
+  ReadImageData(chunky, w, h);
 
-  PushChunk(DstIff, ID_SQWK, CT_ENTITY, sizeof(struct CHUNK_HEADER) + sizeof(struct ENTITY));
-  WriteChunkBytes(DstIff, &hdr, sizeof(struct CHUNK_HEADER));
-  WriteChunkBytes(DstIff, &ent, sizeof(struct ENTITY));
-  PopChunk(DstIff);
+  minX = w;
+  minY = h;
+  maxX = -1;
+  maxY = -1;
 
-  AddToTable(&EntityTable, id, CurrentArchiveId, hdr.ch_Flags, sizeof(struct ENTITY));
-}
+  for (y = 0; y < h; y++)
+  {
+    ry = hitBox->rt_Top + y;
 
-#endif
+    for (x = 0; x < w; x++)
+    {
+      rx = hitBox->rt_Left + x;
 
-STATIC VOID ReadStringIntoName(CHAR* name)
-{
-  UWORD ii;
-  CHAR ch;
+      if (rx >= BackdropWidth || ry >= BackdropHeight)
+        continue;
+
+      if (chunky[y * w + x] != BackdropChunky[ry * BackdropWidth + rx])
+      {
+        if (x < minX) minX = x;
+        if (x > maxX) maxX = x;
+        if (y < minY) minY = y;
+        if (y > maxY) maxY = y;
+      }
+    }
+  }
 
-  while (ii < MAX_ENTITY_NAME_LENGTH)
+  if (maxX < 0)
   {
-    ch = ReadUBYTE();
-    *name++ = ch;
-    if (ch == 0)
-      break;
+    FreeVec(chunky);
+    return 0;
   }
-}
 
-STATIC VOID ExportExit(UWORD id, UWORD target, ULONG start)
-{
-  struct CHUNK_HEADER hdr;
-  struct EXIT ent;
-  ULONG nameStart;
+  left = (hitBox->rt_Left + minX) & ~15;
+  top = hitBox->rt_Top + minY;
+  pw = ((hitBox->rt_Left + maxX + 16) & ~15) - left;
+  ph = maxY - minY + 1;
 
-  MemClear(&ent, sizeof(struct ENTITY));
+  if (left + pw > BackdropWidth)
+  {
+    pw = BackdropWidth - left;
+  }
 
-  hdr.ch_Id = id;
-  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
+  patch = AllocVec(pw * ph, MEMF_CLEAR);
 
-  ent.ex_Type = ET_EXIT;
-  ent.ex_Target = target;
-  
-  SeekFile(start + 7);
-   
-  ent.ex_HitBox.rt_Left = ((UWORD)ReadUBYTE()) << 3;
-  ent.ex_HitBox.rt_Top = ((UWORD)(ReadUBYTE() & 0xF)) << 3;
-  ent.ex_HitBox.rt_Right = ((UWORD)ReadUBYTE()) << 3;
-  ent.ex_HitBox.rt_Right += ent.ex_HitBox.rt_Left;
+  for (y = 0; y < ph; y++)
+  {
+    ry = top + y;
 
-  SeekFile(start + 13);
+    for (x = 0; x < pw; x++)
+    {
+      rx = left + x;
 
-  ent.ex_HitBox.rt_Bottom = ((UWORD)(ReadUBYTE() & 0xF8));
-  ent.ex_HitBox.rt_Bottom += ent.ex_HitBox.rt_Top;
+      if (rx >= hitBox->rt_Left && rx < hitBox->rt_Right)
+      {
+        patch[y * pw + x] = chunky[(ry - hitBox->rt_Top) * w + (rx - hitBox->rt_Left)];
+      }
+      else
+      {
+        patch[y * pw + x] = BackdropChunky[ry * BackdropWidth + rx];
+      }
+    }
+  }
 
-  SeekFile(start + ReadUBYTE());
-  ReadStringIntoName(&ent.ex_Name[0]);
-  
-  PushChunk(DstIff, ID_SQWK, CT_ENTITY, sizeof(struct CHUNK_HEADER) + sizeof(struct EXIT));
-  WriteChunkBytes(DstIff, &hdr, sizeof(struct CHUNK_HEADER));
-  WriteChunkBytes(DstIff, &ent, sizeof(struct EXIT));
-  PopChunk(DstIff);
+  ExportImage(OBJECT_IMAGE_ID(id), 1, patch, pw, ph, 0);
+
+  FreeVec(patch);
+  FreeVec(chunky);
+
+  pos->pt_Left = left;
+  pos->pt_Top = top;
 
-  AddToTable(&EntityTable, id, CurrentArchiveId, hdr.ch_Flags, sizeof(struct EXIT));
+  return OBJECT_IMAGE_ID(id);
 }
 
-STATIC VOID ExportEntity(UWORD id, ULONG start)
+/*
+  Writes the room z-plane as a single bitplane image, a set bit is in front of any
+  occluded actor. Rows are word aligned like any other image, so the blitter can use
+  it as a mask source.
+*/
+/*
+  Exports the z-plane found at zOffset in the room. A room without one gets a clear plane,
+  so nothing is hidden behind it.
+*/
+STATIC VOID ExportZPlane(UWORD id, UWORD w, UWORD h, ULONG zOffset)
 {
   struct CHUNK_HEADER hdr;
-  struct ENTITY ent;
-  ULONG nameStart;
+  struct IMAGE image;
+  UBYTE* plane;
+  ULONG  start;
 
-  MemClear(&ent, sizeof(struct ENTITY));
+  FillMem((UBYTE*)&image, sizeof(struct IMAGE), 0);
 
   hdr.ch_Id = id;
-  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
+  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY | CHUNK_FLAG_HAS_DATA;
 
-  ent.en_Type = ET_ACTIVATOR;
+  image.im_Width = w;
+  image.im_Height = h;
+  image.im_Depth = 1;
+  image.im_BytesPerRow = IMAGE_ROW_ECS(w);
+  image.im_PlaneSize = (ULONG) image.im_BytesPerRow * h;
+  image.im_Type = IMT_ZPLANE;
 
-  SeekFile(start + 7);
+  plane = AllocVec(image.im_PlaneSize, MEMF_CLEAR);
 
-  ent.en_HitBox.rt_Left = ((UWORD)ReadUBYTE()) << 3;
+  if (0 != zOffset && zOffset < SrcLfl->lf_Size)
+  {
+    SeekFile(zOffset);
+    ReadZPlaneData(plane, w, h, image.im_BytesPerRow);
+  }
+  else
+  {
+    DebugF("Room %ld has no z-plane", (ULONG) SrcLfl->lf_MmId);
+  }
+
+  start = DstIff.iw_Size;
+
+  IffPushChunk(&DstIff, CT_IMAGE);
+  WriteChunkHeader(&DstIff, &hdr);
+  WriteImage(&DstIff, &image);
+  IffWriteBytes(&DstIff, plane, image.im_PlaneSize);
+  IffPopChunk(&DstIff);
+
+  FreeVec(plane);
+
+  AddSharedToTable(&ImageTable, id, CurrentArchiveId, hdr.ch_Flags, SIZEOF_IMAGE + image.im_PlaneSize, start);
+}
+
+/*
+  Writes a 4 bitplane image chunk from chunky pixels, with rows of bytesPerRow bytes.
+
+  With IMO_MASK a cookie-cut mask plane of every non-transparent pixel is written after the
+  bitplanes, so the player never has to build a mask itself. No image is exported with it
+  yet, it is there for actor costumes and front layers.
+*/
+STATIC VOID ExportImageLayout(UWORD id, UWORD palette, UBYTE* chunky, UWORD w, UWORD h, UWORD options, UWORD bytesPerRow, UWORD arch)
+{
+  struct CHUNK_HEADER hdr;
+  struct IMAGE image;
+  ULONG  planarSize, maskSize, start;
+  UWORD* planar;
+
+  FillMem((UBYTE*)&image, sizeof(struct IMAGE), 0);
+
+  hdr.ch_Id = id;
+  hdr.ch_Flags = arch | CHUNK_FLAG_HAS_DATA;
+
+  image.im_Width = w;
+  image.im_Height = h;
+  image.im_Depth = 4;
+  image.im_Palette = palette;
+  image.im_BytesPerRow = bytesPerRow;
+  image.im_PlaneSize = (ULONG) bytesPerRow * h;
+  image.im_Options = options;
+
+  planarSize = image.im_PlaneSize * image.im_Depth;
+  maskSize = 0;
+
+  if ((options & IMO_MASK) != 0)
+  {
+    maskSize = image.im_PlaneSize;
+  }
+
+  planar = AllocVec(planarSize + maskSize, MEMF_CLEAR);
+
+  PlanarFromChunky(chunky, planar, w, h, image.im_Depth, bytesPerRow);
+
+  if ((options & IMO_MASK) != 0)
+  {
+    PlanarMaskFromChunky(chunky, planar + (planarSize >> 1), w, h, 0, bytesPerRow);
+  }
+
+  start = DstIff.iw_Size;
+
+  IffPushChunk(&DstIff, CT_IMAGE);
+  WriteChunkHeader(&DstIff, &hdr);
+  WriteImage(&DstIff, &image);
+  IffWriteUWORDs(&DstIff, planar, (planarSize + maskSize) >> 1);
+  IffPopChunk(&DstIff);
+
+  FreeVec(planar);
+
+  AddSharedToTable(&ImageTable, id, CurrentArchiveId, hdr.ch_Flags, SIZEOF_IMAGE + planarSize + maskSize, start);
+}
+
+/*
+  Writes an image with word aligned rows. The blitter and the FMODE 0 bitplane fetch both
+  work in words on every chipset, so one chunk is used on any of them.
+*/
+STATIC VOID ExportImage(UWORD id, UWORD palette, UBYTE* chunky, UWORD w, UWORD h, UWORD options)
+{
+  ExportImageLayout(id, palette, chunky, w, h, options, IMAGE_ROW_ECS(w), CHUNK_FLAG_ARCH_ANY);
+}
+
+STATIC VOID ReadStringIntoName(UBYTE* name)
+{
+  UWORD ii;
+  UBYTE ch;
+
+  for (ii = 0; ii < MAX_ENTITY_NAME_LENGTH; ii++)
+  {
+    ch = ReadUBYTE();
+    *name++ = ch;
+    if (ch == 0)
+      break;
+  }
+}
+
+STATIC VOID ExportExit(UWORD id, UWORD target, ULONG start, ULONG imgOffset)
+{
+  struct CHUNK_HEADER hdr;
+  struct EXIT ent;
+
+  FillMem((UBYTE*)&ent, sizeof(struct EXIT), 0);
+
+  hdr.ch_Id = id;
+  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
+
+  ent.ex_Type = ET_EXIT;
+  ent.ex_Target = target;
+  
+  SeekFile(start + 7);
+   
+  ent.ex_HitBox.rt_Left = ((UWORD)ReadUBYTE()) << 3;
+  ent.ex_HitBox.rt_Top = ((UWORD)(ReadUBYTE() & 0xF)) << 3;
+  ent.ex_HitBox.rt_Right = ((UWORD)ReadUBYTE()) << 3;
+  ent.ex_HitBox.rt_Right += ent.ex_HitBox.rt_Left;
+
+  SeekFile(start + 13);
+
+  ent.ex_HitBox.rt_Bottom = ((UWORD)(ReadUBYTE() & 0xF8));
+  ent.ex_HitBox.rt_Bottom += ent.ex_HitBox.rt_Top;
+
+  SeekFile(start + ReadUBYTE());
+  ReadStringIntoName(&ent.ex_Name[0]);
+
+  ent.ex_Image = ExportObjectImage(id, imgOffset, &ent.ex_HitBox, &ent.ex_ImagePos);
+  
+  IffPushChunk(&DstIff, CT_ENTITY);
+  WriteChunkHeader(&DstIff, &hdr);
+  WriteExit(&DstIff, &ent);
+  IffPopChunk(&DstIff);
+
+  AddToTable(&EntityTable, id, CurrentArchiveId, hdr.ch_Flags, SIZEOF_EXIT);
+}
+
+STATIC VOID ExportEntity(UWORD id, ULONG start, ULONG imgOffset)
+{
+  struct CHUNK_HEADER hdr;
+  struct ENTITY ent;
+
+  FillMem((UBYTE*)&ent, sizeof(struct ENTITY), 0);
+
+  hdr.ch_Id = id;
+  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
+
+  ent.en_Type = ET_ACTIVATOR;
+
+  SeekFile(start + 7);
+
+  ent.en_HitBox.rt_Left = ((UWORD)ReadUBYTE()) << 3;
   ent.en_HitBox.rt_Top = ((UWORD)(ReadUBYTE() & 0xF)) << 3;
   ent.en_HitBox.rt_Right = ((UWORD)ReadUBYTE()) << 3;
   ent.en_HitBox.rt_Right += ent.en_HitBox.rt_Left;
@@ -660,328 +1049,1335 @@ STATIC VOID ExportEntity(UWORD id, ULONG start)
   SeekFile(start + ReadUBYTE());
   ReadStringIntoName(&ent.en_Name[0]);
 
-  PushChunk(DstIff, ID_SQWK, CT_ENTITY, sizeof(struct CHUNK_HEADER) + sizeof(struct ENTITY));
-  WriteChunkBytes(DstIff, &hdr, sizeof(struct CHUNK_HEADER));
-  WriteChunkBytes(DstIff, &ent, sizeof(struct ENTITY));
-  PopChunk(DstIff);
+  ent.en_Image = ExportObjectImage(id, imgOffset, &ent.en_HitBox, &ent.en_ImagePos);
+
+  IffPushChunk(&DstIff, CT_ENTITY);
+  WriteChunkHeader(&DstIff, &hdr);
+  WriteEntity(&DstIff, &ent);
+  IffPopChunk(&DstIff);
 
-  AddToTable(&EntityTable, id, CurrentArchiveId, hdr.ch_Flags, sizeof(struct ENTITY));
+  AddToTable(&EntityTable, id, CurrentArchiveId, hdr.ch_Flags, SIZEOF_ENTITY);
 }
 
-STATIC VOID ExportEntities(UWORD numObjects, UWORD* objDat, UWORD* roomExits, UWORD* roomEntities)
+STATIC VOID ExportEntities(UWORD numObjects, UWORD* objImg, UWORD* objDat, UWORD* roomExits, UWORD* roomEntities)
 {
   UWORD  ii, exitCount, objectCount;
   UWORD  mmId, id, target;
   struct MM_OBJECT* mmObj;
 
-  exitCount = 0;
-  objectCount = 0;
+  exitCount = 0;
+  objectCount = 0;
+
+  for (ii = 0; ii < numObjects; ii++)
+  {
+    SeekFile(objDat[ii] + 4);
+
+    mmId = ReadUWORDLE();
+
+    if (FindExit(mmId, &id, &target))
+    {
+      if (exitCount >= MAX_ROOM_EXITS)
+      {
+        DebugF("Maximum exits reached for room! Exit %ld is left out", (ULONG) id);
+        continue;
+      }
+      ExportExit(id, target, objDat[ii], objImg[ii]);
+      roomExits[exitCount++] = id;
+    }
+    else if (FindObject(mmId, &mmObj))
+    {
+      if (objectCount >= MAX_ROOM_ENTITIES)
+      {
+        DebugF("Maximum entities reached for room! Entity %ld is left out", (ULONG) mmObj->ob_Parrot_Id);
+        continue;
+      }
+
+      ExportEntity(mmObj->ob_Parrot_Id, objDat[ii], objImg[ii]);
+      roomEntities[objectCount++] = mmObj->ob_Parrot_Id;
+    }
+  }
+}
+
+STATIC VOID ExportRoom(UWORD id, UWORD backdrop)
+{
+  struct CHUNK_HEADER hdr;
+  struct ROOM room;
+  UWORD  numObjects;
+
+  FillMem((UBYTE*)&room, sizeof(struct ROOM), 0);
+  
+  hdr.ch_Id = id;
+  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
+
+  room.rm_Width = SrcLfl->lf_Width;
+  room.rm_Height = SrcLfl->lf_Height;
+
+  /* HitGridBuild */
+  RoomArenaBytes += ((ULONG) ((room.rm_Width + HIT_CELL_SIZE - 1) >> HIT_CELL_SHIFT) * ((room.rm_Height + HIT_CELL_SIZE - 1) >> HIT_CELL_SHIFT) * sizeof(ULONG) + 3) & ~3;
+  room.rm_Backdrops[0] = backdrop;
+  room.rm_Parallax[0] = 256;
+  room.rm_ZPlane = ZPLANE_IMAGE_ID(backdrop);
+
+  numObjects = SrcLfl->lf_NumObjects;
+
+  ExportEntities(numObjects, &SrcLfl->lf_ObjImg[0], &SrcLfl->lf_ObjDat[0], &room.rm_Exits[0], &room.rm_Entities[0]);
+  
+  IffPushChunk(&DstIff, CT_ROOM);
+  WriteChunkHeader(&DstIff, &hdr);
+  WriteRoom(&DstIff, &room);
+  IffPopChunk(&DstIff);
+
+  AddToTable(&RoomTable, id, CurrentArchiveId, hdr.ch_Flags, SIZEOF_ROOM);
+
+}
+
+STATIC struct LFL_FILE LflFiles[ROOM_COUNT];
+STATIC struct ROOM_JOB RoomJobs[ROOM_COUNT];
+
+STATIC VOID ConvertRoomJob(struct ROOM_JOB* job)
+{
+  UWORD room;
+
+  if (FALSE == job->rj_Lfl->lf_Present || job->rj_Converted)
+  {
+    return;
+  }
+
+  if (FindRoom(job->rj_Lfl->lf_MmId, &room) == FALSE)
+  {
+    DebugF("Room not found %ld", (ULONG) job->rj_Lfl->lf_MmId);
+    return;
+  }
+
+  if (FALSE == OpenLFL(job->rj_Lfl))
+  {
+    DebugF("Room %ld could not be read again", (ULONG) job->rj_Lfl->lf_MmId);
+    return;
+  }
+
+  CurrentJob = job;
+  CurrentArchiveId = room;
+
+  RoomArenaBytes = 0;
+  RoomChipBytes = 0;
+  ChapterArenaBytes = 0;
+
+  OpenParrotIff(room);
+  ExportBackdrop(room, 1);
+  ExportRoom(room, room);
+  CloseParrotIff();
+
+  if (SrcOverrun)
+  {
+    DebugF("Room %ld reads past the end of its LFL file", (ULONG) room);
+  }
+
+  job->rj_RoomArena = RoomArenaBytes;
+  job->rj_RoomChip = RoomChipBytes;
+  job->rj_ChapterArena = ChapterArenaBytes;
+  job->rj_Converted = TRUE;
+
+  FreeVec(BackdropChunky);
+  BackdropChunky = NULL;
+
+  CloseLFL(job->rj_Lfl);
+
+  CurrentJob = NULL;
+}
+
+#if defined(PARROT_HOST)
+
+STATIC pthread_mutex_t JobLock = PTHREAD_MUTEX_INITIALIZER;
+STATIC UWORD NextJob;
+
+STATIC VOID* RoomWorker(VOID* arg)
+{
+  UWORD idx;
+
+  while (TRUE)
+  {
+    pthread_mutex_lock(&JobLock);
+    idx = NextJob++;
+    pthread_mutex_unlock(&JobLock);
+
+    if (idx >= ROOM_COUNT)
+    {
+      break;
+    }
+
+    ConvertRoomJob(&RoomJobs[idx]);
+  }
+
+  return NULL;
+}
+
+STATIC VOID RunRoomJobs()
+{
+  pthread_t threads[64];
+  UWORD ii, count;
+
+  count = NumWorkers;
+
+  if (count > ROOM_COUNT)
+    count = ROOM_COUNT;
+
+  if (count > 64)
+    count = 64;
+
+  NextJob = 0;
+
+  for (ii = 0; ii < count; ii++)
+  {
+    if (0 != pthread_create(&threads[ii], NULL, RoomWorker, NULL))
+    {
+      break;
+    }
+  }
+
+  count = ii;
+
+  /* Converts the remaining rooms on this thread if no worker could be started */
+  if (0 == count)
+  {
+    RoomWorker(NULL);
+  }
+
+  for (ii = 0; ii < count; ii++)
+  {
+    pthread_join(threads[ii], NULL);
+  }
+}
+
+#else
+
+STATIC VOID RunRoomJobs()
+{
+  UWORD ii;
+
+  for (ii = 0; ii < ROOM_COUNT; ii++)
+  {
+    ConvertRoomJob(&RoomJobs[ii]);
+  }
+}
+
+#endif
+
+/*
+    The manifest lists every converted room with a key made from its LFL file, the ids
+    the lookup pass gave out and CONVERTER_VERSION, along with the table rows and memory
+    budget it produced. A room whose key is unchanged and whose archive is still there is
+    not converted again, its rows are taken from the manifest instead.
+
+    The key is two 32-bit hashes from different seeds. The size and hash of the archive
+    are kept as well, so an archive that was changed or left half written is converted
+    again.
+
+    CONVERTER_VERSION must be raised whenever a change to the converter changes its output.
+*/
+#define CONVERTER_VERSION 8
+#define ID_MNFT MAKE_NODE_ID('M','N','F','T')
+#define MANIFEST_CHECK_SEED 0x9E3779B9UL
+
+#define SIZEOF_MANIFEST_ROOM 32
+#define SIZEOF_MANIFEST_ROW  24
+
+STATIC ULONG GetBE32(CONST UBYTE* p)
+{
+  return ((ULONG) p[0] << 24) | ((ULONG) p[1] << 16) | ((ULONG) p[2] << 8) | (ULONG) p[3];
+}
+
+STATIC UWORD GetBE16(CONST UBYTE* p)
+{
+  return (UWORD) ((p[0] << 8) | p[1]);
+}
+
+STATIC struct OBJECT_TABLE* TableForClass(ULONG classType)
+{
+  switch (classType)
+  {
+    case CT_ROOM: return &RoomTable;
+    case CT_IMAGE: return &ImageTable;
+    case CT_ENTITY: return &EntityTable;
+    case CT_PALETTE: return &PaletteTable;
+  }
+
+  return NULL;
+}
+
+STATIC VOID ManifestPath(CHAR* path, ULONG capacity)
+{
+  StrFormat(path, capacity, "%sConvertManiac.manifest", OutputPath);
+}
+
+/*
+    Reads the archive of a room for its size and hash. Returns FALSE if it is not there.
+*/
+STATIC BOOL HashArchive(struct ROOM_JOB* job, ULONG* out_size, ULONG* out_hash)
+{
+  CHAR   path[280];
+  UBYTE* data;
+  UWORD  room;
+
+  if (FindRoom(job->rj_Lfl->lf_MmId, &room) == FALSE)
+    return FALSE;
+
+  StrFormat(path, sizeof(path), "%s%ld.Parrot", OutputPath, (ULONG) room);
+
+  data = IoReadFile(path, out_size);
+
+  if (NULL == data)
+    return FALSE;
+
+  *out_hash = HashBytes(data, *out_size, HashULONG(*out_size, HASH_SEED));
+
+  IoFreeFile(data);
+
+  return TRUE;
+}
+
+STATIC BOOL RestoreJob(struct ROOM_JOB* job, CONST UBYTE* record, ULONG length)
+{
+  UWORD  ii, numRows;
+  ULONG  archiveSize, archiveHash;
+  struct JOB_ROW* row;
+
+  if (length < SIZEOF_MANIFEST_ROOM)
+    return FALSE;
+
+  numRows = GetBE16(record + 2);
+
+  if (GetBE16(record) != job->rj_Lfl->lf_MmId || GetBE32(record + 4) != job->rj_Key || GetBE32(record + 8) != job->rj_Check)
+    return FALSE;
+
+  if (numRows > MAX_JOB_ROWS || length < SIZEOF_MANIFEST_ROOM + (ULONG) numRows * SIZEOF_MANIFEST_ROW)
+    return FALSE;
+
+  if (FALSE == HashArchive(job, &archiveSize, &archiveHash))
+    return FALSE;
+
+  if (archiveSize != GetBE32(record + 12) || archiveHash != GetBE32(record + 16))
+  {
+    DebugF("Archive of room %ld has changed since it was converted", (ULONG) job->rj_Lfl->lf_MmId);
+    return FALSE;
+  }
+
+  job->rj_RoomArena = GetBE32(record + 20);
+  job->rj_RoomChip = GetBE32(record + 24);
+  job->rj_ChapterArena = GetBE32(record + 28);
+  job->rj_NumRows = numRows;
+
+  record += SIZEOF_MANIFEST_ROOM;
+
+  for (ii = 0; ii < numRows; ii++)
+  {
+    row = &job->rj_Rows[ii];
+    row->jr_Table = TableForClass(GetBE32(record));
+    row->jr_Id = GetBE16(record + 4);
+    row->jr_Archive = GetBE16(record + 6);
+    row->jr_Flags = GetBE16(record + 8);
+    row->jr_ChunkId = GetBE16(record + 10);
+    row->jr_Size = GetBE32(record + 12);
+    row->jr_Hash = GetBE32(record + 16);
+    row->jr_ChunkArchive = GetBE16(record + 20);
+    row->jr_Stored = GetBE16(record + 22) != 0;
+
+    if (NULL == row->jr_Table)
+    {
+      job->rj_NumRows = 0;
+      return FALSE;
+    }
+
+    record += SIZEOF_MANIFEST_ROW;
+  }
+
+  job->rj_Unchanged = TRUE;
+  job->rj_Converted = TRUE;
+
+  return TRUE;
+}
+
+STATIC VOID LoadManifest()
+{
+  CHAR   path[280];
+  UBYTE* data;
+  ULONG  size, pos, length;
+  UWORD  ii;
+
+  ManifestPath(path, sizeof(path));
+
+  data = IoReadFile(path, &size);
+
+  if (NULL == data)
+  {
+    return;
+  }
+
+  if (size >= 12 && GetBE32(data) == MAKE_NODE_ID('F','O','R','M') && GetBE32(data + 8) == ID_MNFT)
+  {
+    pos = 12;
+
+    while (pos + 8 <= size)
+    {
+      length = GetBE32(data + pos + 4);
+
+      if (length > size - pos - 8)
+        break;
+
+      if (GetBE32(data + pos) == CT_ROOM)
+      {
+        for (ii = 0; ii < ROOM_COUNT; ii++)
+        {
+          if (RoomJobs[ii].rj_Lfl->lf_Present && FALSE == RoomJobs[ii].rj_Unchanged)
+          {
+            if (RestoreJob(&RoomJobs[ii], data + pos + 8, length))
+              break;
+          }
+        }
+      }
+
+      pos += 8 + length + (length & 1);
+    }
+  }
+
+  IoFreeFile(data);
+}
+
+STATIC VOID SaveManifest()
+{
+  CHAR   path[280];
+  struct IFF_WRITER iw;
+  struct ROOM_JOB* job;
+  struct JOB_ROW* row;
+  UWORD  ii, jj;
+  ULONG  archiveSize, archiveHash;
+
+  ManifestPath(path, sizeof(path));
+
+  if (FALSE == IffOpenWriter(&iw, path, ID_MNFT))
+  {
+    return;
+  }
+
+  for (ii = 0; ii < ROOM_COUNT; ii++)
+  {
+    job = &RoomJobs[ii];
+
+    if (FALSE == job->rj_Converted)
+      continue;
+
+    /* Archives are final here, after the shared chunks have been stripped */
+    if (FALSE == HashArchive(job, &archiveSize, &archiveHash))
+      continue;
+
+    IffPushChunk(&iw, CT_ROOM);
+    IffWriteUWORD(&iw, job->rj_Lfl->lf_MmId);
+    IffWriteUWORD(&iw, job->rj_NumRows);
+    IffWriteULONG(&iw, job->rj_Key);
+    IffWriteULONG(&iw, job->rj_Check);
+    IffWriteULONG(&iw, archiveSize);
+    IffWriteULONG(&iw, archiveHash);
+    IffWriteULONG(&iw, job->rj_RoomArena);
+    IffWriteULONG(&iw, job->rj_RoomChip);
+    IffWriteULONG(&iw, job->rj_ChapterArena);
+
+    for (jj = 0; jj < job->rj_NumRows; jj++)
+    {
+      row = &job->rj_Rows[jj];
+      IffWriteULONG(&iw, row->jr_Table->ot_ClassType);
+      IffWriteUWORD(&iw, row->jr_Id);
+      IffWriteUWORD(&iw, row->jr_Archive);
+      IffWriteUWORD(&iw, row->jr_Flags);
+      IffWriteUWORD(&iw, row->jr_ChunkId);
+      IffWriteULONG(&iw, row->jr_Size);
+      IffWriteULONG(&iw, row->jr_Hash);
+      IffWriteUWORD(&iw, row->jr_ChunkArchive);
+      IffWriteUWORD(&iw, row->jr_Stored ? 1 : 0);
+    }
+
+    IffPopChunk(&iw);
+  }
+
+  if (FALSE == IffCloseWriter(&iw))
+  {
+    DebugF("Could not write %s", path);
+  }
+}
+
+/*
+    Goes through the rows of every room in export order. The first chunk with a payload
+    is kept and later ones are pointed at it. Returns TRUE if a room taken from the
+    manifest has to be converted again, because it no longer holds a chunk that it should
+    now keep, or the chunk it was pointed at is no longer the same.
+*/
+STATIC BOOL ResolveSharedChunks()
+{
+  UWORD  ii, jj;
+  BOOL   again;
+  ULONG  length;
+  CONST UBYTE* data;
+  struct ROOM_JOB* job;
+  struct JOB_ROW* row;
+  struct PAYLOAD* payload;
+
+  NumPayloads = 0;
+  again = FALSE;
+
+  for (ii = 0; ii < ROOM_COUNT; ii++)
+  {
+    job = &RoomJobs[ii];
+    job->rj_Strip = FALSE;
+
+    if (FALSE == job->rj_Converted)
+      continue;
+
+    for (jj = 0; jj < job->rj_NumRows; jj++)
+    {
+      row = &job->rj_Rows[jj];
+
+      if (0 == row->jr_Hash)
+        continue;
+
+      if (row->jr_Stored)
+        data = ChunkPayload(PAYLOAD_SLOT_CHUNK, row->jr_Archive, row->jr_Table->ot_ClassType, row->jr_Id, row->jr_Flags, &length);
+      else
+        data = ChunkPayload(PAYLOAD_SLOT_CHUNK, row->jr_ChunkArchive, row->jr_Table->ot_ClassType, row->jr_ChunkId, row->jr_Flags, &length);
+
+      payload = NULL;
+
+      if (NULL != data)
+      {
+        payload = FindPayload(row->jr_Table->ot_ClassType, row->jr_Size, row->jr_Hash, row->jr_Flags, data, length);
+      }
+
+      if (NULL != payload)
+      {
+        row->jr_ChunkArchive = payload->pl_Archive;
+        row->jr_ChunkId = payload->pl_ChunkId;
+
+        if (row->jr_Stored)
+          job->rj_Strip = TRUE;
+
+        continue;
+      }
+
+      if (FALSE == row->jr_Stored)
+      {
+        job->rj_Unchanged = FALSE;
+        job->rj_Converted = FALSE;
+        job->rj_NumRows = 0;
+        again = TRUE;
+        break;
+      }
+
+      row->jr_ChunkArchive = row->jr_Archive;
+      row->jr_ChunkId = row->jr_Id;
+
+      if (NULL != data)
+      {
+        AddPayload(row->jr_Table->ot_ClassType, row->jr_Size, row->jr_Hash, row->jr_Archive, row->jr_Id, row->jr_Flags);
+      }
+    }
+  }
+
+  /* Archives are rewritten by the jobs and strips that follow */
+  FreeArchiveCache();
+
+  return again;
+}
+
+/*
+    Rewrites the archive of a room without the chunks that are now kept by another row.
+*/
+STATIC VOID StripSharedChunks(struct ROOM_JOB* job)
+{
+  CHAR   path[280];
+  UBYTE* data;
+  ULONG  size, pos, length, type;
+  UWORD  jj, id, flags, room;
+  BOOL   keep;
+  struct IFF_WRITER iw;
+  struct JOB_ROW* row;
+
+  if (FindRoom(job->rj_Lfl->lf_MmId, &room) == FALSE)
+    return;
+
+  StrFormat(path, sizeof(path), "%s%ld.Parrot", OutputPath, (ULONG) room);
+
+  data = IoReadFile(path, &size);
+
+  if (NULL == data)
+  {
+    DebugF("Could not read %s", path);
+    return;
+  }
+
+  if (FALSE == IffOpenWriter(&iw, path, ID_SQWK))
+  {
+    IoFreeFile(data);
+    return;
+  }
+
+  pos = 12;
+
+  while (pos + 8 + SIZEOF_CHUNK_HEADER <= size)
+  {
+    type = GetBE32(data + pos);
+    length = GetBE32(data + pos + 4);
+    id = GetBE16(data + pos + 8);
+    flags = GetBE16(data + pos + 10);
+    keep = TRUE;
+
+    if (length > size - pos - 8)
+      break;
+
+    for (jj = 0; jj < job->rj_NumRows; jj++)
+    {
+      row = &job->rj_Rows[jj];
+
+      if (row->jr_Stored && row->jr_Id == id && row->jr_Flags == flags && row->jr_Table->ot_ClassType == type &&
+          (row->jr_ChunkArchive != row->jr_Archive || row->jr_ChunkId != row->jr_Id))
+      {
+        row->jr_Stored = FALSE;
+        keep = FALSE;
+        break;
+      }
+    }
+
+    if (keep)
+    {
+      IffPushChunk(&iw, type);
+      IffWriteBytes(&iw, data + pos + 8, length);
+      IffPopChunk(&iw);
+    }
+
+    pos += 8 + length + (length & 1);
+  }
+
+  IoFreeFile(data);
+
+  if (FALSE == IffCloseWriter(&iw))
+  {
+    DebugF("Could not write %s", path);
+  }
+}
+
+STATIC VOID ExportRooms()
+{
+  UWORD ii, jj;
+  ULONG lookupKey, lookupCheck;
+  struct ROOM_JOB* job;
+  struct JOB_ROW* row;
+
+  lookupKey = HashLookupTables(HashULONG(CONVERTER_VERSION, HASH_SEED));
+  lookupCheck = HashLookupTables(HashULONG(CONVERTER_VERSION, MANIFEST_CHECK_SEED));
+
+  for (ii = 0; ii < ROOM_COUNT; ii++)
+  {
+    job = &RoomJobs[ii];
+    FillMem((UBYTE*)job, sizeof(struct ROOM_JOB), 0);
+    job->rj_Lfl = &LflFiles[ii];
+
+    if (job->rj_Lfl->lf_Present)
+    {
+      job->rj_Key = HashULONG(job->rj_Lfl->lf_Hash, lookupKey);
+      job->rj_Check = HashULONG(job->rj_Lfl->lf_Check, lookupCheck);
+    }
+  }
+
+  LoadManifest();
+
+  RunRoomJobs();
+
+  while (ResolveSharedChunks())
+  {
+    RunRoomJobs();
+  }
+
+  for (ii = 0; ii < ROOM_COUNT; ii++)
+  {
+    if (RoomJobs[ii].rj_Strip)
+    {
+      StripSharedChunks(&RoomJobs[ii]);
+    }
+  }
+
+  RoomsConverted = 0;
+  RoomsUnchanged = 0;
+
+  /* Merged in export order, so the tables do not depend on which room finished first */
+  for (ii = 0; ii < ROOM_COUNT; ii++)
+  {
+    job = &RoomJobs[ii];
+
+    if (FALSE == job->rj_Converted)
+      continue;
+
+    if (job->rj_Unchanged)
+      RoomsUnchanged++;
+    else
+      RoomsConverted++;
+
+    for (jj = 0; jj < job->rj_NumRows; jj++)
+    {
+      row = &job->rj_Rows[jj];
+      InsertIntoTable(row->jr_Table, row->jr_Id, row->jr_ChunkArchive, row->jr_ChunkId, row->jr_Flags, row->jr_Size);
+    }
+
+    if (job->rj_RoomArena > MaxRoomArena)
+      MaxRoomArena = job->rj_RoomArena;
+
+    if (job->rj_RoomChip > MaxRoomChip)
+      MaxRoomChip = job->rj_RoomChip;
+
+    if (job->rj_ChapterArena > MaxChapterArena)
+      MaxChapterArena = job->rj_ChapterArena;
+  }
+
+  SaveManifest();
+}
+
+/*
+  Image data is run length encoded down each column in turn, left to right.
+
+  The runs are decoded into a column major buffer, where a run is a straight fill and a
+  repeat copies the pixel one column to the left from one image height back. The buffer
+  is then transposed into rows a tile at a time. Runs are clipped to the image, and
+  decoding stops if the file runs out.
+*/
+#define TRANSPOSE_TILE 32
+
+STATIC VOID TransposeColumns(CONST UBYTE* src, UBYTE* tgt, UWORD w, UWORD h)
+{
+  UWORD x0, y0, x, y, xEnd, yEnd;
+
+  for (y0 = 0; y0 < h; y0 += TRANSPOSE_TILE)
+  {
+    yEnd = (h - y0) > TRANSPOSE_TILE ? y0 + TRANSPOSE_TILE : h;
+
+    for (x0 = 0; x0 < w; x0 += TRANSPOSE_TILE)
+    {
+      xEnd = (w - x0) > TRANSPOSE_TILE ? x0 + TRANSPOSE_TILE : w;
+
+      for (y = y0; y < yEnd; y++)
+      {
+        for (x = x0; x < xEnd; x++)
+        {
+          tgt[(ULONG) y * w + x] = src[(ULONG) x * h + y];
+        }
+      }
+    }
+  }
+}
+
+STATIC VOID ReadImageData(UBYTE* tgt, UWORD w, UWORD h)
+{
+  UBYTE* columns;
+  ULONG  pos, total;
+  UWORD  len;
+  UBYTE  r, col;
+
+  total = (ULONG) w * h;
+
+  if (0 == total)
+  {
+    return;
+  }
+
+  columns = AllocVec(total, 0);
+  pos = 0;
+
+  while (pos < total && FALSE == SrcOverrun)
+  {
+    r = ReadUBYTE();
+
+    if (r < 0x80)
+    {
+      len = (r >> 4) & 0xF;
+      col = r & 0xF;
+
+      if (0 == len)
+      {
+        len = ReadUBYTE();
+      }
+
+      while (len-- && pos < total)
+      {
+        columns[pos++] = col;
+      }
+    }
+    else
+    {
+      len = r & 0x7F;
+
+      if (0 == len)
+      {
+        len = ReadUBYTE();
+      }
+
+      while (len-- && pos < total)
+      {
+        columns[pos] = pos >= h ? columns[pos - h] : 0;
+        pos++;
+      }
+    }
+  }
+
+  /* Whatever a short file did not cover stays colour 0 */
+  while (pos < total)
+  {
+    columns[pos++] = 0;
+  }
+
+  TransposeColumns(columns, tgt, w, h);
+
+  FreeVec(columns);
+}
+
+/*
+  Z-plane data is stored as 8 pixel wide strips, top to bottom and then left to right. Each strip
+  byte is already a planar byte. Rows in tgt are bytesPerRow long, anything past the strips is
+  left clear.
+
+  Runs are either a repeat (bit 7 set, length in the low bits, then the byte) or a number of
+  literal bytes.
+*/
+STATIC VOID ReadZPlaneData(UBYTE* tgt, UWORD w, UWORD h, UWORD bytesPerRow)
+{
+  UWORD x, y, bpr;
+  UBYTE r, len, val;
+  BOOL  repeat;
+
+  val = 0;
+  x = 0;
+  y = 0;
+  bpr = (w >> 3);
 
-  for (ii = 0; ii < numObjects; ii++)
+  while (x < bpr && FALSE == SrcOverrun)
   {
-    SeekFile(objDat[ii] + 4);
+    r = ReadUBYTE();
+    repeat = (r & 0x80) != 0;
+    len = r & 0x7F;
 
-    mmId = ReadUWORDLE();
+    if (0 == len)
+    {
+      len = ReadUBYTE();
+    }
 
-    if (FindExit(mmId, &id, &target))
+    if (repeat)
     {
-      if (exitCount >= MAX_ROOM_EXITS)
-      {
-        DebugF("Maximum exits reached for room!");
-        return;
-      }
-      ExportExit(id, target, objDat[ii]);
-      roomExits[exitCount++] = id;
+      val = ReadUBYTE();
     }
-    else if (FindObject(mmId, &mmObj))
+
+    while (len-- && x < bpr)
     {
-      if (objectCount >= MAX_ROOM_ENTITIES)
+      if (!repeat)
       {
-        DebugF("Maximum exits reached for room!");
-        return;
+        val = ReadUBYTE();
       }
 
-      ExportEntity(mmObj->ob_Parrot_Id, objDat[ii]);
-      roomEntities[objectCount++] = mmObj->ob_Parrot_Id;
+      tgt[y * bytesPerRow + x] = val;
+      y++;
+
+      if (y >= h)
+      {
+        y = 0;
+        x++;
+      }
     }
   }
 }
 
-STATIC VOID ExportRoom(UWORD id, UWORD backdrop)
+/*
+    Reads and de-obfuscates the LFL file, and reads its header. Returns FALSE if it could not
+    be read.
+*/
+STATIC BOOL OpenLFL(struct LFL_FILE* lfl)
 {
-  struct CHUNK_HEADER hdr;
-  struct ROOM room;
-  UWORD  numObjects;
-  UWORD  objImg[256];
-  UWORD  objDat[256];
-  UWORD  ii;
+  CHAR   path[512];
+  UWORD  jj;
 
-  MemClear(&room, sizeof(struct ROOM));
-  
-  hdr.ch_Id = id;
-  hdr.ch_Flags = CHUNK_FLAG_ARCH_ANY;
+  StrFormat(path, sizeof(path), "%s%02ld.LFL", InputPath, (ULONG) lfl->lf_MmId);
+
+  lfl->lf_Data = IoReadFile(path, &lfl->lf_Size);
+
+  if (NULL == lfl->lf_Data)
+  {
+    return FALSE;
+  }
+
+  XorMem(lfl->lf_Data, lfl->lf_Size, 0xFF);
+
+  SelectLFL(lfl);
 
   SeekFile(4);
-  room.rm_Width = ReadUWORDLE();
-  room.rm_Height = ReadUWORDLE();
-  room.rm_Backdrops[0] = backdrop;
+  lfl->lf_Width = ReadUWORDLE();
+  lfl->lf_Height = ReadUWORDLE();
+
+  SeekFile(10);
+  lfl->lf_ImageOffset = ReadUWORDLE();
+  lfl->lf_ZPlaneOffset = ReadUWORDLE();
 
   SeekFile(20);
-  numObjects = ReadUBYTE();
+  lfl->lf_NumObjects = ReadUBYTE();
+
+  SeekFile(28);
 
-  if (numObjects > MAX_ROOM_ENTITIES)
+  for (jj = 0; jj < lfl->lf_NumObjects; jj++)
   {
-    DebugF("Maximum entity count exceeded! %ld vs %ld in Room %ld", (ULONG) numObjects, (ULONG) MAX_ROOM_ENTITIES, (ULONG) id);
-    return;
+    lfl->lf_ObjImg[jj] = ReadUWORDLE();
   }
 
-  SeekFile(28);
-
-  for (ii = 0; ii < numObjects; ii++)
+  for (jj = 0; jj < lfl->lf_NumObjects; jj++)
   {
-    objImg[ii] = ReadUWORDLE();
+    lfl->lf_ObjDat[jj] = ReadUWORDLE();
   }
 
-  for (ii = 0; ii < numObjects; ii++)
+  if (SrcOverrun)
   {
-    objDat[ii] = ReadUWORDLE();
+    DebugF("Header of %s is truncated", path);
   }
 
-  ExportEntities(numObjects, &objDat[0], &room.rm_Exits[0], &room.rm_Entities[0]);
-  
-  PushChunk(DstIff, ID_SQWK, CT_ROOM, sizeof(struct CHUNK_HEADER) + sizeof(struct ROOM));
-  WriteChunkBytes(DstIff, &hdr, sizeof(struct CHUNK_HEADER));
-  WriteChunkBytes(DstIff, &room, sizeof(struct ROOM));
-  PopChunk(DstIff);
+  return TRUE;
+}
 
-  AddToTable(&RoomTable, id, CurrentArchiveId, hdr.ch_Flags, sizeof(struct ROOM));
+STATIC VOID CloseLFL(struct LFL_FILE* lfl)
+{
+  if (NULL != lfl->lf_Data)
+  {
+    IoFreeFile(lfl->lf_Data);
+    lfl->lf_Data = NULL;
+  }
 
+  if (SrcLfl == lfl)
+  {
+    SrcLfl = NULL;
+  }
 }
 
-STATIC VOID ExportRooms()
+/*
+    Looks through the verb scripts of the object at start for a loadRoomWithEgo with a
+    constant object and room, which is what every door does. Returns FALSE if there is none.
+
+    The scripts are scanned a byte at a time rather than decoded, so a match is only kept
+    once LinkExits has found the object it names in the room it names.
+*/
+#define OP_LOAD_ROOM_WITH_EGO 0x24
+
+STATIC BOOL FindExitScript(ULONG start, UWORD* out_mmTarget, UWORD* out_mmRoom)
 {
-  UWORD ii;
-  UWORD mmId;
-  UWORD room;
+  ULONG  end, pos, scriptStart, offset;
+  UBYTE  nameOffset;
+  UBYTE* p;
 
-  for (ii = 0; ii < ROOM_COUNT; ii++)
+  SeekFile(start);
+  end = start + ReadUWORDLE();
+
+  SeekFile(start + 14);
+  nameOffset = ReadUBYTE();
+
+  if (SrcOverrun || end > SrcLfl->lf_Size || start + nameOffset > end)
+  {
+    return FALSE;
+  }
+
+  /* The verb table is pairs of verb and script offset, ending with verb 0 */
+  scriptStart = end;
+
+  for (pos = start + 15; pos + 1 < start + nameOffset && SrcFileData[pos] != 0; pos += 2)
   {
-    mmId = RoomExportOrder[ii];
+    offset = start + SrcFileData[pos + 1];
 
-    if (OpenLFL("PROGDIR:", mmId) > 0)
+    if (offset < scriptStart)
     {
-      CurrentArchiveId = room;
+      scriptStart = offset;
+    }
+  }
 
-      if (FindRoom(mmId, &room) == FALSE)
-      {
-        DebugF("Room not found %ld", mmId);
-        return;
-      }
+  /* loadRoomWithEgo object.w room.b x.b y.b */
+  for (pos = scriptStart; pos + 6 <= end; pos++)
+  {
+    p = SrcFileData + pos;
 
-      OpenParrotIff(room);
-      ExportRoom(room, room);
-      ExportBackdrop(room, 1);
-      CloseParrotIff();
-      CloseLFL();
+    if (OP_LOAD_ROOM_WITH_EGO == p[0] && 0 != p[3] && p[3] < MM_MAX_ROOMS && (0 != p[1] || 0 != p[2]))
+    {
+      *out_mmTarget = p[1] | ((UWORD) p[2] << 8);
+      *out_mmRoom = p[3];
+      return TRUE;
     }
   }
 
+  return FALSE;
 }
 
-STATIC VOID ReadImageData(UBYTE* tgt, UWORD w, UWORD h)
+STATIC BOOL IsInExportOrder(UWORD mmId)
 {
-  UWORD x, y;
-  UBYTE r, len, col;
-  ULONG offset;
+  UWORD ii;
 
-  x = 0;
-  y = 0;
+  for (ii = 0; ii < EXPORT_ORDER_COUNT; ii++)
+  {
+    if (RoomExportOrder[ii] == mmId)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*
+    Goes through every room, those in RoomExportOrder first. Each file is read here for its
+    header, content hash, objects and exits, then let go of until its room is converted.
+*/
+STATIC VOID LoadLFLs()
+{
+  UWORD  ii, jj, count, mmId, mmTarget, mmRoom;
+  struct LFL_FILE* lfl;
+
+  ClearLookupTables();
 
-  offset = 0;
+  count = 0;
 
-  while (x < w)
+  for (ii = 0; ii < EXPORT_ORDER_COUNT; ii++)
   {
-    r = ReadUBYTE();
+    LflFiles[count++].lf_MmId = RoomExportOrder[ii];
+  }
 
-    if (r < 0x80)
+  for (mmId = 1; mmId < MM_MAX_ROOMS && count < ROOM_COUNT; mmId++)
+  {
+    if (FALSE == IsInExportOrder(mmId))
     {
-      len = (r >> 4) & 0xF;
-      col = r & 0xF;
+      LflFiles[count++].lf_MmId = mmId;
+    }
+  }
 
-      if (0 == len)
-      {
-        len = ReadUBYTE();
-      }
+  for (ii = 0; ii < ROOM_COUNT; ii++)
+  {
+    lfl = &LflFiles[ii];
+    mmId = lfl->lf_MmId;
 
-      while(len--)
-      {
-        tgt[offset] = col;
-        y++;
-        offset += w;
-        if (y >= h)
-        {
-          y = 0;
-          x++;
-          offset = x;
-        }
-      }
+    FillMem((UBYTE*)lfl, sizeof(struct LFL_FILE), 0);
+    lfl->lf_MmId = mmId;
 
-    }
-    else
+    if (0 == mmId || FALSE == OpenLFL(lfl))
     {
-      len = r & 0x7F;
+      continue;
+    }
 
-      if (0 == len)
-      {
-        len = ReadUBYTE();
-      }
+    lfl->lf_Present = TRUE;
+    lfl->lf_Hash = HashBytes(lfl->lf_Data, lfl->lf_Size, HashULONG(lfl->lf_Size, HASH_SEED));
+    lfl->lf_Check = HashBytes(lfl->lf_Data, lfl->lf_Size, HashULONG(lfl->lf_Size, MANIFEST_CHECK_SEED));
 
-      while (len--)
+    for (jj = 0; jj < lfl->lf_NumObjects; jj++)
+    {
+      SeekFile(lfl->lf_ObjDat[jj] + 4);
+      lfl->lf_ObjId[jj] = ReadUWORDLE();
+
+      if (FindExitScript(lfl->lf_ObjDat[jj], &mmTarget, &mmRoom))
       {
-        col = tgt[offset - 1];
-        tgt[offset] = col;
-        offset += w;
-        y++;
-        if (y >= h)
-        {
-          y = 0;
-          x++;
-          offset = x;
-        }
+        AddExit(lfl->lf_ObjId[jj], mmTarget, mmRoom);
       }
     }
 
+    CloseLFL(lfl);
   }
 }
 
-STATIC VOID ConvertImageDataToPlanar(UBYTE* src, UWORD* dst, UWORD w, UWORD h)
+STATIC VOID SelectLFL(struct LFL_FILE* lfl)
 {
-  ULONG idx;
-  UBYTE bp, shift;
-  UWORD y, x, i;
-  idx = 0;
+  SrcLfl = lfl;
+  SrcFileData = lfl->lf_Data;
+  SrcFilePos = SrcFileData;
+  SrcFileEnd = SrcFileData + lfl->lf_Size;
+  SrcOverrun = FALSE;
+}
+
+
+STATIC BOOL SeekFile(ULONG pos)
+{
+  UBYTE* nextPos;
+
+  nextPos = SrcFileData + pos;
 
-  for (bp = 0; bp < 4; bp++)
+  if (nextPos < SrcFileEnd)
   {
-    UBYTE shift = 1 << bp;
-    idx = 0;
+    SrcFilePos = nextPos;
 
-    for (y = 0; y < h; y++)
-    {
-      for (x = 0; x < w; x += 16)
-      {
-        UWORD word = 0;
+    return TRUE;
+  }
 
-        for (i = 0; i < 16; i++)
-        {
-          UBYTE col = src[idx + x + i];
-          UBYTE bit = (col & shift) != 0 ? 1 : 0;
+  return FALSE;
+}
 
-          if (bit)
-            word |= (1 << (15 - i));
-        }
 
-        *dst++ = word;
-      }
-      idx += w;
+STATIC BOOL SameBytes(CONST UBYTE* a, CONST UBYTE* b, ULONG length)
+{
+  while (length-- > 0)
+  {
+    if (*a++ != *b++)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*
+    Returns the payload kept with the same bytes as data, which is a chunk with the given
+    flags, or NULL if there is none.
+*/
+STATIC struct PAYLOAD* FindPayload(ULONG classType, ULONG size, ULONG hash, UWORD flags, CONST UBYTE* data, ULONG length)
+{
+  ULONG ii, keptLength;
+  CONST UBYTE* kept;
+  struct PAYLOAD* payload;
+
+  for (ii = 0; ii < NumPayloads; ii++)
+  {
+    payload = &Payloads[ii];
+
+    if (payload->pl_Hash != hash || payload->pl_Size != size || payload->pl_ClassType != classType || payload->pl_Flags != flags)
+      continue;
+
+    kept = ChunkPayload(PAYLOAD_SLOT_KEPT, payload->pl_Archive, classType, payload->pl_ChunkId, flags, &keptLength);
+
+    if (NULL != kept && keptLength == length && SameBytes(kept, data, length))
+    {
+      return payload;
     }
 
+    DebugF("Chunk %ld:%ld has the hash of a different payload", (ULONG) payload->pl_Archive, (ULONG) payload->pl_ChunkId);
   }
+
+  return NULL;
 }
 
-STATIC VOID MemClear(APTR pMem, ULONG size)
+STATIC VOID AddPayload(ULONG classType, ULONG size, ULONG hash, UWORD archive, UWORD chunkId, UWORD flags)
 {
-  ULONG ii;
-  UBYTE* m;
-
-  m = (UBYTE*)pMem;
+  struct PAYLOAD* payload;
 
-  for (ii = 0; ii < size; ii++)
+  if (NumPayloads >= MAX_PAYLOADS)
   {
-    m[ii] = 0;
+    return;
   }
+
+  payload = &Payloads[NumPayloads++];
+  payload->pl_ClassType = classType;
+  payload->pl_Size = size;
+  payload->pl_Hash = hash;
+  payload->pl_Archive = archive;
+  payload->pl_ChunkId = chunkId;
+  payload->pl_Flags = flags;
 }
 
-STATIC ULONG OpenLFL(CHAR* basePath, UWORD id)
+/*
+    Finds the bytes after the chunk header of a chunk in an archive. Archive 0 is only
+    kept while it is being written, so it is read from DstIff. Room archives are read
+    from the output path into the given slot. Returns NULL if the chunk is not there.
+*/
+STATIC CONST UBYTE* ChunkPayload(UWORD slot, UWORD archive, ULONG classType, UWORD id, UWORD flags, ULONG* out_length)
 {
-  CHAR path[512];
+  CHAR   path[280];
+  CONST UBYTE* data;
+  ULONG  size, pos, length;
+  struct ARCHIVE_CACHE* cache;
 
-  ULONG len;
-  BPTR  file;
+  if (0 == archive)
+  {
+    data = DstIff.iw_Data;
+    size = DstIff.iw_Size;
+  }
+  else
+  {
+    cache = &ArchiveCache[slot];
+
+    if (NULL == cache->ac_Data || cache->ac_Archive != archive)
+    {
+      if (NULL != cache->ac_Data)
+      {
+        IoFreeFile(cache->ac_Data);
+      }
 
-  StrFormat(path, sizeof(path), "%s%02ld.LFL", basePath, (ULONG) id);
+      StrFormat(path, sizeof(path), "%s%ld.Parrot", OutputPath, (ULONG) archive);
 
-  file = Open(path, MODE_OLDFILE);
+      cache->ac_Archive = archive;
+      cache->ac_Data = IoReadFile(path, &cache->ac_Size);
 
-  if (NULL == file)
-  {
-    return 0ul;
+      if (NULL == cache->ac_Data)
+      {
+        DebugF("Could not read %s", path);
+        return NULL;
+      }
+    }
+
+    data = cache->ac_Data;
+    size = cache->ac_Size;
   }
 
-  Seek(file, 0, OFFSET_END);
-  len = Seek(file, 0, OFFSET_BEGINING);
+  if (NULL == data)
+    return NULL;
 
-  SrcFileData = AllocVec(len, 0);
-  SrcFilePos = SrcFileData;
-  SrcFileEnd = SrcFileData + len;
+  pos = 12;
+
+  while (pos + 8 + SIZEOF_CHUNK_HEADER <= size)
+  {
+    length = GetBE32(data + pos + 4);
+
+    if (length > size - pos - 8 || length < SIZEOF_CHUNK_HEADER)
+      break;
 
-  Read(file, SrcFileData, len);
+    if (GetBE32(data + pos) == classType && GetBE16(data + pos + 8) == id && GetBE16(data + pos + 10) == flags)
+    {
+      *out_length = length - SIZEOF_CHUNK_HEADER;
+      return data + pos + 8 + SIZEOF_CHUNK_HEADER;
+    }
 
-  Close(file);
+    pos += 8 + length + (length & 1);
+  }
 
-  return len;
+  return NULL;
 }
 
-STATIC VOID CloseLFL()
+STATIC VOID FreeArchiveCache()
 {
-  if (NULL != SrcFileData)
+  UWORD ii;
+
+  for (ii = 0; ii < 2; ii++)
   {
-    FreeVec(SrcFileData);
-    SrcFileData = NULL;
+    if (NULL != ArchiveCache[ii].ac_Data)
+    {
+      IoFreeFile(ArchiveCache[ii].ac_Data);
+      ArchiveCache[ii].ac_Data = NULL;
+    }
   }
 }
 
-
-STATIC BOOL SeekFile(ULONG pos)
+/*
+    Chunks that may be shared, images and palettes, are hashed as they are added. A row
+    from a room job is only recorded, duplicates between rooms are found when the rooms
+    are merged. In archive 0 rows are added straight to the tables, so a duplicate chunk
+    is taken back out of the archive as soon as it is written.
+*/
+STATIC VOID AddRowToTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD flags, ULONG size, ULONG hash, ULONG chunkStart)
 {
-  UBYTE* nextPos;
+  ULONG  length;
+  struct JOB_ROW* row;
+  struct PAYLOAD* payload;
 
-  nextPos = SrcFileData + pos;
+  if (table == &RoomTable)
+  {
+    ChapterArenaBytes += ASSET_ARENA_SIZE(size);
+  }
+  else if ((table == &ImageTable || table == &EntityTable) && (flags & CHUNK_FLAG_ARCH_AGA) != 0)
+  {
+    /* Counted once, every chunk read on AGA is read on any chipset */
+    RoomArenaBytes += ASSET_ARENA_SIZE(size);
 
-  if (nextPos < SrcFileEnd)
+    if (table == &ImageTable)
+    {
+      RoomChipBytes += size - SIZEOF_IMAGE;
+    }
+  }
+
+  if (NULL == CurrentJob)
   {
-    SrcFilePos = nextPos;
+    payload = NULL;
 
-    return TRUE;
+    if (0 != hash)
+    {
+      length = GetBE32(DstIff.iw_Data + chunkStart + 4) - SIZEOF_CHUNK_HEADER;
+      payload = FindPayload(table->ot_ClassType, size, hash, flags, DstIff.iw_Data + chunkStart + 8 + SIZEOF_CHUNK_HEADER, length);
+    }
+
+    if (NULL != payload)
+    {
+      DstIff.iw_Size = chunkStart;
+      InsertIntoTable(table, id, payload->pl_Archive, payload->pl_ChunkId, flags, size);
+      return;
+    }
+
+    if (0 != hash)
+    {
+      AddPayload(table->ot_ClassType, size, hash, archive, id, flags);
+    }
+
+    InsertIntoTable(table, id, archive, id, flags, size);
+    return;
   }
 
-  return FALSE;
+  if (CurrentJob->rj_NumRows >= MAX_JOB_ROWS)
+  {
+    DebugF("Maximum table rows reached for room!");
+    return;
+  }
+
+  row = &CurrentJob->rj_Rows[CurrentJob->rj_NumRows++];
+  row->jr_Table = table;
+  row->jr_Id = id;
+  row->jr_Archive = archive;
+  row->jr_Flags = flags;
+  row->jr_Size = size;
+  row->jr_Hash = hash;
+  row->jr_ChunkArchive = archive;
+  row->jr_ChunkId = id;
+  row->jr_Stored = TRUE;
 }
 
-STATIC BOOL JumpFile(LONG extraPos)
+STATIC VOID AddToTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD flags, ULONG size)
 {
-  UBYTE* nextPos;
+  AddRowToTable(table, id, archive, flags, size, 0, 0);
+}
 
-  nextPos = SrcFileData + (SrcFilePos - SrcFileData) + extraPos;
+/*
+    Adds a row for the chunk that starts at chunkStart in DstIff, it must be the last one
+    written. The hash covers the flags and everything after the chunk header, so two chunks
+    with the same data but different ids are the same.
+*/
+STATIC VOID AddSharedToTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD flags, ULONG size, ULONG chunkStart)
+{
+  ULONG dataStart, hash;
 
-  if (nextPos < SrcFileEnd)
-  {
-    SrcFilePos = nextPos;
+  dataStart = chunkStart + 8 + SIZEOF_CHUNK_HEADER;
 
-    return TRUE;
+  hash = HashBytes(DstIff.iw_Data + dataStart, DstIff.iw_Size - dataStart, HashULONG(flags, HashULONG(size, HASH_SEED)));
+
+  /* 0 means not shared */
+  if (0 == hash)
+  {
+    hash = 1;
   }
 
-  return FALSE;
+  AddRowToTable(table, id, archive, flags, size, hash, chunkStart);
 }
 
-STATIC VOID AddToTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD flags, ULONG size)
+STATIC VOID InsertIntoTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWORD chunkId, UWORD flags, ULONG size)
 {
   struct OBJECT_TABLE_ITEM* item;
 
+  while (NULL != NextTable(table))
+  {
+    table = NextTable(table);
+  }
+
   item = (struct OBJECT_TABLE_ITEM*) table->ot_Next;
 
+  /* The last item is kept empty, it ends the table for the player */
+  if (item >= &table->ot_Items[MAX_ITEMS_PER_TABLE - 1])
+  {
+    if (NumExtraTables >= MAX_EXTRA_TABLES)
+    {
+      DebugF("Maximum tables reached!");
+      return;
+    }
+
+    table->ot_NextRef.tr_ClassType = table->ot_ClassType;
+    table->ot_NextRef.tr_ChunkHeaderId = EXTRA_TABLE_ID(NumExtraTables);
+    table->ot_NextRef.tr_ArchiveId = 0;
+
+    InitTable(&ExtraTables[NumExtraTables], table->ot_ClassType);
+    table = &ExtraTables[NumExtraTables++];
+    item = (struct OBJECT_TABLE_ITEM*) table->ot_Next;
+  }
+
   item->ot_Id = id;
   item->ot_Archive = archive;
+  item->ot_ChunkId = chunkId;
   item->ot_Flags = flags;
   item->ot_Size = size;
 
@@ -1000,7 +2396,7 @@ STATIC VOID AddToTable(struct OBJECT_TABLE* table, UWORD id, UWORD archive, UWOR
 
 STATIC VOID InitTable(struct OBJECT_TABLE* table, ULONG classType)
 {
-  MemClear(table, sizeof(struct OBJECT_TABLE));
+  FillMem((UBYTE*)table, sizeof(struct OBJECT_TABLE), 0);
 
   table->ot_ClassType = classType;
   table->ot_IdMin = 65535;
@@ -1008,6 +2404,16 @@ STATIC VOID InitTable(struct OBJECT_TABLE* table, ULONG classType)
   table->ot_Next = &table->ot_Items[0];
 }
 
+STATIC struct OBJECT_TABLE* NextTable(struct OBJECT_TABLE* table)
+{
+  if (0 == table->ot_NextRef.tr_ClassType)
+  {
+    return NULL;
+  }
+
+  return &ExtraTables[table->ot_NextRef.tr_ChunkHeaderId - EXTRA_TABLE_ID(0)];
+}
+
 STATIC VOID ExportTable(struct OBJECT_TABLE* table, UWORD id, UWORD tableRefSlot)
 {
   struct CHUNK_HEADER hdr;
@@ -1032,10 +2438,10 @@ STATIC VOID ExportTable(struct OBJECT_TABLE* table, UWORD id, UWORD tableRefSlot
   t = table->ot_Next;
   table->ot_Next = NULL;
 
-  PushChunk(DstIff, ID_SQWK, CT_TABLE, sizeof(struct CHUNK_HEADER) + sizeof(struct OBJECT_TABLE));
-  WriteChunkBytes(DstIff, &hdr, sizeof(struct CHUNK_HEADER));
-  WriteChunkBytes(DstIff, table, sizeof(struct OBJECT_TABLE));
-  PopChunk(DstIff);
+  IffPushChunk(&DstIff, CT_TABLE);
+  WriteChunkHeader(&DstIff, &hdr);
+  WriteObjectTable(&DstIff, table);
+  IffPopChunk(&DstIff);
 
   table->ot_Next = t;
 
@@ -1046,61 +2452,51 @@ STATIC VOID ExportTable(struct OBJECT_TABLE* table, UWORD id, UWORD tableRefSlot
     ref->tr_ClassType = table->ot_ClassType;
   }
 
+  if (NULL != NextTable(table))
+  {
+    ExportTable(NextTable(table), table->ot_NextRef.tr_ChunkHeaderId, 16);
+  }
 }
 
 STATIC VOID ResolveLookupTables()
 {
   UWORD ii, jj;
-  UWORD objDat[256];
-  UWORD objCount;
-  UWORD exitId;
   UWORD mmId;
-  UWORD mmRoom;
   UWORD roomId;
   UWORD objectId;
+  struct LFL_FILE* lfl;
+  struct MM_EXIT* ex;
 
   roomId = 1;
   objectId = 1;
 
   for (ii = 0; ii < ROOM_COUNT; ii++)
   {
-    mmRoom = RoomExportOrder[ii];
+    lfl = &LflFiles[ii];
 
-    if (OpenLFL("PROGDIR:", mmRoom) > 0)
+    if (lfl->lf_Present)
     {
+      AddRoom(lfl->lf_MmId, roomId);
 
-      SeekFile(20);
-      objCount = ReadUBYTE();
-
-      AddRoom(mmRoom, roomId);
-      SeekFile(28 + objCount * sizeof(UWORD));
-
-      for (jj = 0; jj < objCount; jj++)
-      {
-        objDat[jj] = ReadUWORDLE();
-      }
-
-      for (jj = 0; jj < objCount; jj++)
+      for (jj = 0; jj < lfl->lf_NumObjects; jj++)
       {
-        SeekFile(objDat[jj] + 4);
+        mmId = lfl->lf_ObjId[jj];
+        ex = FindMmExit(mmId);
 
-        mmId = ReadUWORDLE();
-
-        if (AddExit(mmId, objectId))
-        {
-          objectId++;
-        }
-        else
+        if (NULL != ex)
         {
-          AddObject(mmId, objectId, roomId);
-          objectId++;
+          ex->ex_Parrot_Id = objectId;
         }
 
+        AddObject(mmId, objectId, roomId, NULL != ex ? ET_EXIT : ET_ACTIVATOR);
+        objectId++;
       }
 
       roomId++;
-
-      CloseLFL();
     }
   }
+
+  NumRooms = roomId - 1;
+
+  LinkExits();
 }
@@ -0,0 +1,194 @@
+/**
+    $Id: Serialise.h, 1.0, 2026/10/19 14:20:00, betajaen Exp $
+
+    Maniac Game Converter for Parrot
+    ================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    Chunk data is written a field at a time, big-endian and in the layout the structures have
+    on the Amiga, where anything larger than a byte is aligned to two bytes. Pointers are
+    always written as 0, the player fills them in when the asset is loaded.
+
+    The sizes are of the structures on the Amiga, and are checked against sizeof there.
+*/
+
+#define SIZEOF_CHUNK_HEADER   4
+#define SIZEOF_PALETTE_TABLE  258
+#define SIZEOF_GAME_INFO      502
+#define SIZEOF_IMAGE          56
+#define SIZEOF_ENTITY         48
+#define SIZEOF_EXIT           50
+#define SIZEOF_ROOM           74
+#define SIZEOF_OBJECT_TABLE   1044
+
+#if defined(IS_M68K)
+typedef char CheckSizeOfPaletteTable[sizeof(struct PALETTE_TABLE) == SIZEOF_PALETTE_TABLE ? 1 : -1];
+typedef char CheckSizeOfGameInfo[sizeof(struct GAME_INFO) == SIZEOF_GAME_INFO ? 1 : -1];
+typedef char CheckSizeOfImage[sizeof(struct IMAGE) == SIZEOF_IMAGE ? 1 : -1];
+typedef char CheckSizeOfEntity[sizeof(struct ENTITY) == SIZEOF_ENTITY ? 1 : -1];
+typedef char CheckSizeOfExit[sizeof(struct EXIT) == SIZEOF_EXIT ? 1 : -1];
+typedef char CheckSizeOfRoom[sizeof(struct ROOM) == SIZEOF_ROOM ? 1 : -1];
+typedef char CheckSizeOfObjectTable[sizeof(struct OBJECT_TABLE) == SIZEOF_OBJECT_TABLE ? 1 : -1];
+#endif
+
+STATIC VOID WriteChunkHeader(struct IFF_WRITER* iw, struct CHUNK_HEADER* hdr)
+{
+  IffWriteUWORD(iw, hdr->ch_Id);
+  IffWriteUWORD(iw, hdr->ch_Flags);
+}
+
+STATIC VOID WriteRect(struct IFF_WRITER* iw, struct RECT* rect)
+{
+  IffWriteUWORD(iw, rect->rt_Left);
+  IffWriteUWORD(iw, rect->rt_Top);
+  IffWriteUWORD(iw, rect->rt_Right);
+  IffWriteUWORD(iw, rect->rt_Bottom);
+}
+
+STATIC VOID WritePoint(struct IFF_WRITER* iw, struct POINT* point)
+{
+  IffWriteUWORD(iw, point->pt_Left);
+  IffWriteUWORD(iw, point->pt_Top);
+}
+
+STATIC VOID WriteTableRef(struct IFF_WRITER* iw, struct OBJECT_TABLE_REF* ref)
+{
+  IffWriteULONG(iw, ref->tr_ClassType);
+  IffWriteUWORD(iw, ref->tr_ChunkHeaderId);
+  IffWriteUWORD(iw, ref->tr_ArchiveId);
+}
+
+STATIC VOID WritePaletteTable(struct IFF_WRITER* iw, struct PALETTE_TABLE* pal)
+{
+  UWORD ii;
+
+  IffWriteUBYTE(iw, pal->pt_Begin);
+  IffWriteUBYTE(iw, pal->pt_End);
+
+  for (ii = 0; ii < 64; ii++)
+  {
+    IffWriteULONG(iw, pal->pt_Data[ii]);
+  }
+}
+
+STATIC VOID WriteGameInfo(struct IFF_WRITER* iw, struct GAME_INFO* info)
+{
+  UWORD ii;
+
+  IffWriteULONG(iw, info->gi_GameId);
+  IffWriteULONG(iw, info->gi_GameVersion);
+  IffWriteBytes(iw, info->gi_Title, sizeof(info->gi_Title));
+  IffWriteBytes(iw, info->gi_ShortTitle, sizeof(info->gi_ShortTitle));
+  IffWriteBytes(iw, info->gi_Author, sizeof(info->gi_Author));
+  IffWriteBytes(iw, info->gi_Release, sizeof(info->gi_Release));
+  IffWriteUWORD(iw, info->gi_Width);
+  IffWriteUWORD(iw, info->gi_Height);
+  IffWriteUWORD(iw, info->gi_Depth);
+  IffWriteUWORD(iw, info->gi_RoomCount);
+
+  for (ii = 0; ii < 16; ii++)
+  {
+    WriteTableRef(iw, &info->gi_StartTables[ii]);
+  }
+
+  IffWriteUWORD(iw, info->gi_StartPalette);
+  IffWriteUWORD(iw, info->gi_StartCursorPalette);
+  IffWriteUWORD(iw, info->gi_StartRoom);
+  IffWriteULONG(iw, info->gi_RoomArena);
+  IffWriteULONG(iw, info->gi_RoomChip);
+  IffWriteULONG(iw, info->gi_ChapterArena);
+  IffWriteULONG(iw, info->gi_TableArena);
+}
+
+STATIC VOID WriteImage(struct IFF_WRITER* iw, struct IMAGE* image)
+{
+  IffWriteUWORD(iw, image->im_BytesPerRow);
+  IffWriteUWORD(iw, image->im_Height);
+  IffWriteUBYTE(iw, image->im_Flags);
+  IffWriteUBYTE(iw, image->im_Depth);
+  IffWriteUWORD(iw, image->im_pad);
+  IffWritePad(iw, 8 * 4);                 /* im_Planes */
+  IffWriteUWORD(iw, image->im_Width);
+  IffWriteUWORD(iw, image->im_Palette);
+  IffWriteULONG(iw, image->im_PlaneSize);
+  IffWriteUWORD(iw, image->im_Options);
+  IffWriteUWORD(iw, image->im_Type);
+  IffWritePad(iw, 4);                     /* im_Mask */
+}
+
+STATIC VOID WriteEntity(struct IFF_WRITER* iw, struct ENTITY* ent)
+{
+  IffWriteUWORD(iw, ent->en_Type);
+  IffWriteUWORD(iw, ent->en_Flags);
+  WriteRect(iw, &ent->en_HitBox);
+  IffWriteUWORD(iw, ent->en_Image);
+  WritePoint(iw, &ent->en_ImagePos);
+  IffWriteBytes(iw, ent->en_Name, sizeof(ent->en_Name));
+}
+
+STATIC VOID WriteExit(struct IFF_WRITER* iw, struct EXIT* ex)
+{
+  IffWriteUWORD(iw, ex->ex_Type);
+  IffWriteUWORD(iw, ex->ex_Flags);
+  WriteRect(iw, &ex->ex_HitBox);
+  IffWriteUWORD(iw, ex->ex_Image);
+  WritePoint(iw, &ex->ex_ImagePos);
+  IffWriteBytes(iw, ex->ex_Name, sizeof(ex->ex_Name));
+  IffWriteUWORD(iw, ex->ex_Target);
+}
+
+STATIC VOID WriteRoom(struct IFF_WRITER* iw, struct ROOM* room)
+{
+  IffWriteUWORD(iw, room->rm_Width);
+  IffWriteUWORD(iw, room->rm_Height);
+  IffWriteUWORDs(iw, room->rm_Backdrops, MAX_ROOM_BACKDROPS);
+  IffWriteUWORDs(iw, room->rm_Parallax, MAX_ROOM_BACKDROPS);
+  IffWriteUWORD(iw, room->rm_ZPlane);
+  IffWriteUWORDs(iw, room->rm_Exits, MAX_ROOM_EXITS);
+  IffWriteUWORDs(iw, room->rm_Entities, MAX_ROOM_ENTITIES);
+}
+
+STATIC VOID WriteObjectTable(struct IFF_WRITER* iw, struct OBJECT_TABLE* table)
+{
+  struct OBJECT_TABLE_ITEM* item;
+  UWORD ii;
+
+  IffWritePad(iw, 4);                     /* ot_Next */
+  WriteTableRef(iw, &table->ot_NextRef);
+  IffWriteULONG(iw, table->ot_ClassType);
+  IffWriteUWORD(iw, table->ot_IdMin);
+  IffWriteUWORD(iw, table->ot_IdMax);
+
+  for (ii = 0; ii < MAX_ITEMS_PER_TABLE; ii++)
+  {
+    item = &table->ot_Items[ii];
+
+    IffWriteUWORD(iw, item->ot_Id);
+    IffWriteUWORD(iw, item->ot_Archive);
+    IffWriteUWORD(iw, item->ot_Flags);
+    IffWriteUWORD(iw, item->ot_ChunkId);
+    IffWriteULONG(iw, item->ot_Size);
+    IffWritePad(iw, 4);                   /* ot_Ptr */
+  }
+}
@@ -25,18 +25,26 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#include <exec/types.h>
+#include <Parrot/Parrot.h>
 
 #define MM_MAX_ROOMS   55
 #define MM_MAX_OBJECTS 1024
+#define MM_MAX_EXITS   512
 
+/*
+    Every room from 1 to MM_MAX_ROOMS - 1 that has an LFL file is exported. These come first,
+    in this order, so the rooms the game starts in keep the lowest ids. The rest follow in
+    room number order.
+*/
 UWORD RoomExportOrder[] = {
   44,
   1,
   10
 };
 
-#define ROOM_COUNT (sizeof(RoomExportOrder) / sizeof(UWORD))
+#define EXPORT_ORDER_COUNT (sizeof(RoomExportOrder) / sizeof(RoomExportOrder[0]))
+
+#define ROOM_COUNT (MM_MAX_ROOMS - 1)
 
 struct RM_Table
 {
@@ -46,19 +54,21 @@ struct RM_Table
 
 STATIC struct RM_Table MM_RoomId_Table[MM_MAX_ROOMS] = { 0 };
 
+/*
+    An exit is an object whose scripts move the player to another room. ex_Mm_Target is the
+    object the player is put next to in ex_Mm_Room, the exit leads to that object.
+*/
 struct MM_EXIT
 {
   UWORD ex_Mm_Id;
   UWORD ex_Mm_Target;
+  UWORD ex_Mm_Room;
   UWORD ex_Parrot_Id;
   UWORD ex_Parrot_Target;
 };
 
-STATIC struct MM_EXIT Mm_Exit_Table[] = {
-  { 258 /* 44 */ , 257 /* 1 */, 0,0 },
-  { 61 /* 1 */, 67 /* 10 */, 0,0  },
-  { 0,0, 0,0}
-};
+STATIC struct MM_EXIT Mm_Exit_Table[MM_MAX_EXITS] = { 0 };
+STATIC UWORD Mm_Exit_Count = 0;
 
 struct MM_OBJECT
 {
@@ -70,47 +80,70 @@ struct MM_OBJECT
 
 STATIC struct MM_OBJECT MM_Object_Table[MM_MAX_OBJECTS] = { 0 };
 
+STATIC VOID ClearLookupTables()
+{
+  FillMem((UBYTE*) &MM_RoomId_Table[0], sizeof(MM_RoomId_Table), 0);
+  FillMem((UBYTE*) &Mm_Exit_Table[0], sizeof(Mm_Exit_Table), 0);
+  FillMem((UBYTE*) &MM_Object_Table[0], sizeof(MM_Object_Table), 0);
+  Mm_Exit_Count = 0;
+}
+
 STATIC VOID AddRoom(UWORD mmId, UWORD parrotId)
 {
   MM_RoomId_Table[mmId].rt_Mm = mmId;
   MM_RoomId_Table[mmId].rt_Parrot = parrotId;
 }
 
-STATIC VOID AddObject(UWORD mmId, UWORD parrotId, UWORD parrotRoom)
+STATIC VOID AddObject(UWORD mmId, UWORD parrotId, UWORD parrotRoom, UWORD parrotType)
 {
+  if (mmId >= MM_MAX_OBJECTS)
+  {
+    return;
+  }
+
   MM_Object_Table[mmId].ob_Mm_Id = mmId;
   MM_Object_Table[mmId].ob_Parrot_Id = parrotId;
   MM_Object_Table[mmId].ob_Parrot_Room = parrotRoom;
+  MM_Object_Table[mmId].ob_Parrot_Type = parrotType;
 }
 
-STATIC BOOL AddExit(UWORD mmId, UWORD parrotId)
+STATIC BOOL AddExit(UWORD mmId, UWORD mmTarget, UWORD mmRoom)
 {
   struct MM_EXIT* ex;
 
-  ex = &Mm_Exit_Table[0];
+  if (Mm_Exit_Count >= MM_MAX_EXITS - 1)
+  {
+    return FALSE;
+  }
+
+  ex = &Mm_Exit_Table[Mm_Exit_Count++];
+  ex->ex_Mm_Id = mmId;
+  ex->ex_Mm_Target = mmTarget;
+  ex->ex_Mm_Room = mmRoom;
+  ex->ex_Parrot_Id = 0;
+  ex->ex_Parrot_Target = 0;
+
+  return TRUE;
+}
 
-  while (ex->ex_Mm_Id != 0)
+STATIC struct MM_EXIT* FindMmExit(UWORD mmId)
+{
+  struct MM_EXIT* ex;
+
+  for (ex = &Mm_Exit_Table[0]; ex->ex_Mm_Id != 0; ex++)
   {
     if (ex->ex_Mm_Id == mmId)
     {
-      ex->ex_Parrot_Id = parrotId;
-      return TRUE;
-    }
-
-    if (ex->ex_Mm_Target == mmId)
-    {
-      ex->ex_Parrot_Target = parrotId;
-      return TRUE;
+      return ex;
     }
-
-    ex++;
   }
-  return FALSE;
+
+  return NULL;
 }
 
 STATIC BOOL FindRoom(UWORD mmId, UWORD* out_parrotId)
 {
-  if (mmId >= 55)
+  if (mmId >= MM_MAX_ROOMS)
   {
     return FALSE;
   }
@@ -122,47 +155,87 @@ STATIC BOOL FindRoom(UWORD mmId, UWORD* out_parrotId)
 
 STATIC BOOL FindObject(UWORD mmId, struct MM_OBJECT** obj)
 {
-  UWORD ii;
+  if (mmId == 0 || mmId >= MM_MAX_OBJECTS || MM_Object_Table[mmId].ob_Mm_Id != mmId)
+  {
+    (*obj) = NULL;
+    return FALSE;
+  }
 
-  for (ii = 0; ii < MM_MAX_OBJECTS; ii++)
+  (*obj) = &MM_Object_Table[mmId];
+
+  return TRUE;
+}
+
+/*
+    Gives each exit the id of the object it leads to. An exit is only kept if that object
+    was exported, and is in the room the script names, anything else is taken to be a
+    script that was not a door after all and the object is exported as an entity.
+*/
+STATIC VOID LinkExits()
+{
+  struct MM_EXIT* ex;
+  struct MM_OBJECT* target;
+  struct MM_OBJECT* self;
+  UWORD room;
+
+  for (ex = &Mm_Exit_Table[0]; ex->ex_Mm_Id != 0; ex++)
   {
-    (*obj) = &MM_Object_Table[ii];
+    ex->ex_Parrot_Target = 0;
 
-    if ((*obj)->ob_Mm_Id == mmId)
+    if (FindObject(ex->ex_Mm_Target, &target) && FindRoom(ex->ex_Mm_Room, &room) && room != 0 && target->ob_Parrot_Room == room)
+    {
+      ex->ex_Parrot_Target = target->ob_Parrot_Id;
+    }
+    else if (FindObject(ex->ex_Mm_Id, &self))
     {
-      return TRUE;
+      self->ob_Parrot_Type = ET_ACTIVATOR;
     }
   }
-
-  (*obj) = NULL;
-
-  return FALSE;
 }
 
 STATIC BOOL FindExit(UWORD mmId, UWORD* out_parrotId, UWORD* out_targetId)
 {
   struct MM_EXIT* ex;
 
-  ex = &Mm_Exit_Table[0];
+  ex = FindMmExit(mmId);
 
-  while (ex->ex_Mm_Id != 0)
+  if (NULL == ex || 0 == ex->ex_Parrot_Target)
   {
-    if (ex->ex_Mm_Id == mmId)
-    {
-      *out_parrotId = ex->ex_Parrot_Id;
-      *out_targetId = ex->ex_Parrot_Target;
-      return TRUE;
-    }
+    return FALSE;
+  }
 
-    if (ex->ex_Mm_Target == mmId)
-    {
-      *out_parrotId = ex->ex_Parrot_Target;
-      *out_targetId = ex->ex_Parrot_Id;
-      return TRUE;
-    }
+  *out_parrotId = ex->ex_Parrot_Id;
+  *out_targetId = ex->ex_Parrot_Target;
 
-    ex++;
+  return TRUE;
+}
+
+/*
+    Hashes every id the lookup pass gave out. A room converts differently if the id of any
+    room, exit or object it refers to moves, so this is part of each room's manifest key.
+*/
+STATIC ULONG HashLookupTables(ULONG hash)
+{
+  UWORD ii;
+  struct MM_EXIT* ex;
+
+  for (ii = 0; ii < MM_MAX_ROOMS; ii++)
+  {
+    hash = HashULONG(((ULONG) MM_RoomId_Table[ii].rt_Mm << 16) | MM_RoomId_Table[ii].rt_Parrot, hash);
+  }
+
+  for (ex = &Mm_Exit_Table[0]; ex->ex_Mm_Id != 0; ex++)
+  {
+    hash = HashULONG(((ULONG) ex->ex_Mm_Id << 16) | ex->ex_Mm_Target, hash);
+    hash = HashULONG(((ULONG) ex->ex_Parrot_Id << 16) | ex->ex_Parrot_Target, hash);
+    hash = HashULONG(ex->ex_Mm_Room, hash);
+  }
+
+  for (ii = 0; ii < MM_MAX_OBJECTS; ii++)
+  {
+    hash = HashULONG(((ULONG) MM_Object_Table[ii].ob_Mm_Id << 16) | MM_Object_Table[ii].ob_Parrot_Id, hash);
+    hash = HashULONG(((ULONG) MM_Object_Table[ii].ob_Parrot_Room << 16) | MM_Object_Table[ii].ob_Parrot_Type, hash);
   }
 
-  return FALSE;
+  return hash;
 }
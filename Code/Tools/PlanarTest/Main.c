@@ -0,0 +1,248 @@
+/**
+    $Id: Main.c, 1.0, 2026/10/19 16:10:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/Planar.h>
+
+#include <string.h>
+#include <time.h>
+
+/*
+    Checks PlanarFromChunky and PlanarMaskFromChunky against the plain bit at a time routines
+    they replaced, and times them against each other.
+
+      PlanarTest         Compares every width from 1 to 100 and some wider ones, at depths
+                         1 to 8, heights 1 to 3 and 200, and word and AGA row lengths.
+      PlanarTest bench   Times a 640x200 4 bitplane image.
+*/
+
+#define ROW_ECS(W) ((((W) + 15) >> 4) << 1)
+#define ROW_AGA(W) ((((W) + 63) >> 6) << 3)
+
+#define MAX_WIDTH  640
+#define MAX_HEIGHT 200
+#define MAX_DEPTH  8
+#define PAD_WORD   0xA55A
+
+STATIC UBYTE  Chunky[MAX_WIDTH * MAX_HEIGHT];
+STATIC UWORD  Expected[(ROW_AGA(MAX_WIDTH) >> 1) * MAX_HEIGHT * MAX_DEPTH];
+STATIC UWORD  Actual[(ROW_AGA(MAX_WIDTH) >> 1) * MAX_HEIGHT * MAX_DEPTH];
+
+/*
+    The converter's original routines, one plane and one bit at a time, but stopping at the
+    width instead of reading the next row.
+*/
+STATIC VOID RefPlanarFromChunky(CONST UBYTE* src, UWORD* dst, UWORD w, UWORD h, UWORD depth, UWORD bytesPerRow)
+{
+  UWORD bp, x, y, i, word;
+  UWORD* row;
+
+  for (bp = 0; bp < depth; bp++)
+  {
+    for (y = 0; y < h; y++)
+    {
+      row = dst + ((ULONG) bp * h + y) * (bytesPerRow >> 1);
+
+      for (x = 0; x < w; x += 16)
+      {
+        word = 0;
+
+        for (i = 0; i < 16 && x + i < w; i++)
+        {
+          if ((src[(ULONG) y * w + x + i] & (1 << bp)) != 0)
+            word |= (1 << (15 - i));
+        }
+
+        *row++ = word;
+      }
+    }
+  }
+}
+
+STATIC VOID RefPlanarMaskFromChunky(CONST UBYTE* src, UWORD* dst, UWORD w, UWORD h, UBYTE transparent, UWORD bytesPerRow)
+{
+  UWORD x, y, i, word;
+  UWORD* row;
+
+  for (y = 0; y < h; y++)
+  {
+    row = dst + (ULONG) y * (bytesPerRow >> 1);
+
+    for (x = 0; x < w; x += 16)
+    {
+      word = 0;
+
+      for (i = 0; i < 16 && x + i < w; i++)
+      {
+        if (src[(ULONG) y * w + x + i] != transparent)
+          word |= (1 << (15 - i));
+      }
+
+      *row++ = word;
+    }
+  }
+}
+
+STATIC VOID FillPad(UWORD* dst, ULONG words)
+{
+  while (words--)
+  {
+    *dst++ = PAD_WORD;
+  }
+}
+
+STATIC VOID FillChunky(UWORD w, UWORD h, ULONG seed)
+{
+  ULONG ii;
+
+  for (ii = 0; ii < (ULONG) w * h; ii++)
+  {
+    seed = seed * 1664525ul + 1013904223ul;
+    Chunky[ii] = (UBYTE) (seed >> 24);
+  }
+}
+
+/*
+    Returns the number of mismatches, both outputs start out filled with PAD_WORD so padding
+    that should be left alone is checked too.
+*/
+STATIC ULONG Compare(UWORD w, UWORD h, UWORD depth, UWORD bytesPerRow)
+{
+  ULONG words, fails;
+
+  fails = 0;
+  words = (ULONG) (bytesPerRow >> 1) * h * depth;
+
+  FillPad(Expected, words);
+  FillPad(Actual, words);
+
+  RefPlanarFromChunky(Chunky, Expected, w, h, depth, bytesPerRow);
+  PlanarFromChunky(Chunky, Actual, w, h, depth, bytesPerRow);
+
+  if (memcmp(Expected, Actual, words * sizeof(UWORD)) != 0)
+  {
+    printf("PlanarFromChunky differs at %ux%u depth %u row %u\n", w, h, depth, bytesPerRow);
+    fails++;
+  }
+
+  words = (ULONG) (bytesPerRow >> 1) * h;
+
+  FillPad(Expected, words);
+  FillPad(Actual, words);
+
+  RefPlanarMaskFromChunky(Chunky, Expected, w, h, Chunky[0], bytesPerRow);
+  PlanarMaskFromChunky(Chunky, Actual, w, h, Chunky[0], bytesPerRow);
+
+  if (memcmp(Expected, Actual, words * sizeof(UWORD)) != 0)
+  {
+    printf("PlanarMaskFromChunky differs at %ux%u row %u\n", w, h, bytesPerRow);
+    fails++;
+  }
+
+  return fails;
+}
+
+STATIC INT Test()
+{
+  STATIC CONST UWORD wide[] = { 128, 255, 256, 319, 320, 321, 328, 480, 639, 640 };
+  STATIC CONST UWORD heights[] = { 1, 2, 3, MAX_HEIGHT };
+  UWORD w, ii, hh, depth;
+  ULONG fails, runs;
+
+  fails = 0;
+  runs = 0;
+
+  for (ii = 0; ii < 100 + sizeof(wide) / sizeof(wide[0]); ii++)
+  {
+    w = ii < 100 ? ii + 1 : wide[ii - 100];
+
+    for (hh = 0; hh < sizeof(heights) / sizeof(heights[0]); hh++)
+    {
+      FillChunky(w, heights[hh], w * 31 + hh);
+
+      for (depth = 1; depth <= MAX_DEPTH; depth++)
+      {
+        fails += Compare(w, heights[hh], depth, ROW_ECS(w));
+        fails += Compare(w, heights[hh], depth, ROW_AGA(w));
+        runs += 2;
+      }
+    }
+  }
+
+  printf("%lu of %lu comparisons failed\n", (unsigned long) fails, (unsigned long) runs);
+
+  return fails == 0 ? RETURN_OK : RETURN_FAIL;
+}
+
+STATIC double Seconds(clock_t start)
+{
+  return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+STATIC INT Bench()
+{
+  UWORD  ii, loops;
+  clock_t start;
+  double ref, fast;
+
+  loops = 200;
+
+  FillChunky(MAX_WIDTH, MAX_HEIGHT, 1);
+
+  start = clock();
+
+  for (ii = 0; ii < loops; ii++)
+  {
+    RefPlanarFromChunky(Chunky, Expected, MAX_WIDTH, MAX_HEIGHT, 4, ROW_ECS(MAX_WIDTH));
+  }
+
+  ref = Seconds(start);
+  start = clock();
+
+  for (ii = 0; ii < loops; ii++)
+  {
+    PlanarFromChunky(Chunky, Actual, MAX_WIDTH, MAX_HEIGHT, 4, ROW_ECS(MAX_WIDTH));
+  }
+
+  fast = Seconds(start);
+
+  printf("%ux%u 4 bitplanes, %u images\n", MAX_WIDTH, MAX_HEIGHT, loops);
+  printf("  reference        %8.2f ms per image\n", ref * 1000.0 / loops);
+  printf("  PlanarFromChunky %8.2f ms per image, %.1fx\n", fast * 1000.0 / loops, fast > 0 ? ref / fast : 0.0);
+
+  return RETURN_OK;
+}
+
+INT main(INT argc, CHAR** argv)
+{
+  if (argc > 1 && strcmp(argv[1], "bench") == 0)
+  {
+    return Bench();
+  }
+
+  return Test();
+}
@@ -0,0 +1,315 @@
+/**
+    $Id: Main.c, 1.0, 2026/10/19 18:40:00, betajaen Exp $
+
+    Parrot - Point and Click Adventure Game Player
+    ==============================================
+
+    Copyright 2020 Robin Southern http://github.com/betajaen/parrot
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Parrot/Parrot.h>
+#include <Parrot/String.h>
+
+#include <string.h>
+#include <time.h>
+
+/*
+    Checks FillMem and XorMem against plain byte loops, and times them against each other.
+
+      StringTest         Every destination alignment from 0 to 7 with every length up to
+                         300 and some longer ones. The bytes either side of the destination
+                         must be left alone. StrFormat is checked at the edges of a LONG and
+                         with a %s longer than a UWORD can count.
+      StringTest bench   Fills of a few sizes, aligned and not, and copies with CopyMem
+                         against a byte loop.
+*/
+
+#define GUARD      16
+#define MAX_LENGTH 65536
+#define GUARD_BYTE 0xA5
+#define FORMAT_TEXT 70000
+
+STATIC UBYTE  Source[MAX_LENGTH + 2 * GUARD];
+STATIC UBYTE  Expected[MAX_LENGTH + 2 * GUARD];
+STATIC UBYTE  Actual[MAX_LENGTH + 2 * GUARD];
+STATIC CHAR   FormatText[FORMAT_TEXT + 1];
+STATIC CHAR   FormatOut[FORMAT_TEXT + 16];
+
+STATIC VOID RefFill(UBYTE* dst, ULONG length, UBYTE value)
+{
+  while (length--)
+  {
+    *dst++ = value;
+  }
+}
+
+STATIC VOID RefCopy(UBYTE* dst, CONST UBYTE* src, ULONG length)
+{
+  while (length--)
+  {
+    *dst++ = *src++;
+  }
+}
+
+STATIC VOID RefXor(UBYTE* dst, ULONG length, UBYTE value)
+{
+  while (length--)
+  {
+    *dst++ ^= value;
+  }
+}
+
+STATIC VOID FillSource(ULONG seed)
+{
+  ULONG ii;
+
+  for (ii = 0; ii < sizeof(Source); ii++)
+  {
+    seed = seed * 1664525ul + 1013904223ul;
+    Source[ii] = (UBYTE) (seed >> 24);
+  }
+}
+
+/*
+    Both buffers start out as the same pattern, so anything written outside of the length
+    shows up as a difference.
+*/
+STATIC VOID ResetBuffers(ULONG length)
+{
+  memset(Expected, GUARD_BYTE, length + 2 * GUARD);
+  memset(Actual, GUARD_BYTE, length + 2 * GUARD);
+}
+
+STATIC ULONG Compare(CONST CHAR* name, UWORD dstAlign, ULONG length)
+{
+  if (memcmp(Expected, Actual, length + 8 + 2 * GUARD) != 0)
+  {
+    printf("%s differs at destination %u length %lu\n", name, dstAlign, (unsigned long) length);
+    return 1;
+  }
+
+  return 0;
+}
+
+STATIC ULONG Check(UWORD dstAlign, ULONG length)
+{
+  UBYTE* expected;
+  UBYTE* actual;
+  ULONG fails;
+
+  fails = 0;
+  expected = Expected + GUARD + dstAlign;
+  actual = Actual + GUARD + dstAlign;
+
+  ResetBuffers(length + 8);
+  RefFill(expected, length, (UBYTE) length);
+  FillMem(actual, length, (UBYTE) length);
+  fails += Compare("FillMem", dstAlign, length);
+
+  RefCopy(Expected, Source, length + 8 + 2 * GUARD);
+  RefCopy(Actual, Source, length + 8 + 2 * GUARD);
+  RefXor(expected, length, 0xFF);
+  XorMem(actual, length, 0xFF);
+  fails += Compare("XorMem", dstAlign, length);
+
+  return fails;
+}
+
+STATIC ULONG CheckFormat(CONST CHAR* expected, ULONG length)
+{
+  if (length != StrLen(expected) + 1 || strcmp(FormatOut, expected) != 0)
+  {
+    printf("StrFormat gave \"%.40s\" for \"%.40s\"\n", FormatOut, expected);
+    return 1;
+  }
+
+  return 0;
+}
+
+STATIC ULONG CheckFormats()
+{
+  ULONG fails, length;
+
+  fails = 0;
+
+  length = StrFormat(FormatOut, sizeof(FormatOut), "%ld", (LONG) 0x80000000UL);
+  fails += CheckFormat("-2147483648", length);
+
+  length = StrFormat(FormatOut, sizeof(FormatOut), "%ld %lu %lx", (LONG) 0x7FFFFFFF, (ULONG) 0xFFFFFFFFUL, (ULONG) 0xFFFFFFFFUL);
+  fails += CheckFormat("2147483647 4294967295 ffffffff", length);
+
+  length = StrFormat(FormatOut, sizeof(FormatOut), "%05ld|%-4ld|", (LONG) -12, (LONG) 7);
+  fails += CheckFormat("-0012|7   |", length);
+
+  memset(FormatText, 'a', FORMAT_TEXT);
+  FormatText[FORMAT_TEXT] = '\0';
+
+  length = StrFormat(FormatOut, sizeof(FormatOut), "%s", FormatText);
+  fails += CheckFormat(FormatText, length);
+
+  length = StrFormat(FormatOut, sizeof(FormatOut), "%s|", FormatText + 1);
+  FormatText[FORMAT_TEXT - 1] = '|';
+  fails += CheckFormat(FormatText, length);
+
+  length = StrFormat(FormatOut, sizeof(FormatOut), "%70005s", "x");
+  if (length != 70006 || FormatOut[70003] != ' ' || FormatOut[70004] != 'x')
+  {
+    printf("StrFormat padded %%70005s to %lu\n", (unsigned long) length);
+    fails++;
+  }
+
+  return fails;
+}
+
+STATIC INT Test()
+{
+  STATIC CONST ULONG longer[] = { 511, 512, 513, 1000, 4096, 4099, MAX_LENGTH - 8 };
+  UWORD dstAlign, ii;
+  ULONG length, fails, runs;
+
+  fails = 0;
+  runs = 0;
+
+  FillSource(1);
+
+  for (ii = 0; ii <= 300 + sizeof(longer) / sizeof(longer[0]); ii++)
+  {
+    length = ii <= 300 ? ii : longer[ii - 301];
+
+    for (dstAlign = 0; dstAlign < 8; dstAlign++)
+    {
+      fails += Check(dstAlign, length);
+      runs += 2;
+    }
+  }
+
+  fails += CheckFormats();
+  runs += 6;
+
+  printf("%lu of %lu comparisons failed\n", (unsigned long) fails, (unsigned long) runs);
+
+  return fails == 0 ? RETURN_OK : RETURN_FAIL;
+}
+
+STATIC double Seconds(clock_t start)
+{
+  return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+/*
+    Every size moves the same 64 MB in total, so the times compare between sizes too. A
+    byte of the destination is read back each time, so the work can not be left out.
+*/
+STATIC VOID BenchSize(ULONG length, UWORD dstAlign, UWORD srcAlign)
+{
+  ULONG ii, loops, sum;
+  clock_t start;
+  double copyRef, copyMem, fillRef, fillMem, xorRef, xorMem;
+  UBYTE* dst;
+  CONST UBYTE* src;
+
+  loops = (64ul * 1024 * 1024) / length;
+  dst = Actual + GUARD + dstAlign;
+  src = Source + GUARD + srcAlign;
+  sum = 0;
+
+  start = clock();
+  for (ii = 0; ii < loops; ii++)
+  {
+    RefCopy(dst, src, length);
+    sum += dst[ii % length];
+  }
+  copyRef = Seconds(start);
+
+  start = clock();
+  for (ii = 0; ii < loops; ii++)
+  {
+    CopyMem(src, dst, length);
+    sum += dst[ii % length];
+  }
+  copyMem = Seconds(start);
+
+  start = clock();
+  for (ii = 0; ii < loops; ii++)
+  {
+    RefFill(dst, length, (UBYTE) ii);
+    sum += dst[ii % length];
+  }
+  fillRef = Seconds(start);
+
+  start = clock();
+  for (ii = 0; ii < loops; ii++)
+  {
+    FillMem(dst, length, (UBYTE) ii);
+    sum += dst[ii % length];
+  }
+  fillMem = Seconds(start);
+
+  start = clock();
+  for (ii = 0; ii < loops; ii++)
+  {
+    RefXor(dst, length, (UBYTE) ii);
+    sum += dst[ii % length];
+  }
+  xorRef = Seconds(start);
+
+  start = clock();
+  for (ii = 0; ii < loops; ii++)
+  {
+    XorMem(dst, length, (UBYTE) ii);
+    sum += dst[ii % length];
+  }
+  xorMem = Seconds(start);
+
+  printf("%6lu bytes at %u/%u  loop %6.1f CopyMem %6.1f  loop %6.1f FillMem %6.1f  loop %6.1f XorMem %6.1f  (%lu)\n",
+    (unsigned long) length, dstAlign, srcAlign,
+    copyRef * 1000.0, copyMem * 1000.0, fillRef * 1000.0, fillMem * 1000.0, xorRef * 1000.0, xorMem * 1000.0,
+    (unsigned long) (sum & 1));
+}
+
+STATIC INT Bench()
+{
+  STATIC CONST ULONG sizes[] = { 16, 64, 256, 4096, MAX_LENGTH - 8 };
+  UWORD ii;
+
+  FillSource(1);
+
+  printf("ms to move 64 MB, destination/source alignment\n");
+
+  for (ii = 0; ii < sizeof(sizes) / sizeof(sizes[0]); ii++)
+  {
+    BenchSize(sizes[ii], 0, 0);
+    BenchSize(sizes[ii], 1, 1);
+    BenchSize(sizes[ii], 2, 1);
+  }
+
+  return RETURN_OK;
+}
+
+INT main(INT argc, CHAR** argv)
+{
+  if (argc > 1 && strcmp(argv[1], "bench") == 0)
+  {
+    return Bench();
+  }
+
+  return Test();
+}